@@ -40,12 +40,17 @@ namespace fastdds {
 
 Client::Client(
         Participant* participant,
+        ConversionContext* conversion,
         const std::string& service_name,
         const xtypes::DynamicType& request_type,
         const xtypes::DynamicType& reply_type,
         ServiceClientSystem::RequestCallback* callback,
-        const YAML::Node& config)
+        const YAML::Node& config,
+        ReceptionWaitSet* waitset,
+        const RealTime* realtime)
     : participant_(participant)
+    , waitset_(waitset)
+    , realtime_(realtime)
     , service_name_(service_name)
     , request_entities_(request_type)
     , reply_entities_(reply_type)
@@ -60,8 +65,8 @@ Client::Client(
     add_config(config, callback);
 
     // Create DynamicData
-    DynamicTypeBuilder* builder_request = Conversion::create_builder(request_type);
-    DynamicTypeBuilder* builder_reply = Conversion::create_builder(reply_type);
+    DynamicTypeBuilder* builder_request = conversion->create_builder(request_type);
+    DynamicTypeBuilder* builder_reply = conversion->create_builder(reply_type);
 
     if (builder_request != nullptr)
     {
@@ -97,16 +102,9 @@ Client::Client(
 
     // Create request entities
     {
-        // Create DDS subscriber
-        request_entities_.dds_subscriber = dds_participant->create_subscriber(
-            ::fastdds::dds::SUBSCRIBER_QOS_DEFAULT);
-        if (request_entities_.dds_subscriber)
-        {
-            logger_ << utils::Logger::Level::DEBUG
-                    << "Created Fast DDS subscriber for service '"
-                    << service_name << "' request" << std::endl;
-        }
-        else
+        // Get the DDS subscriber shared with the topics in the default partition
+        request_entities_.dds_subscriber = participant->get_dds_subscriber(::fastdds::dds::PartitionQosPolicy());
+        if (!request_entities_.dds_subscriber)
         {
             std::ostringstream err;
             err << "Fast DDS subscriber for service '"
@@ -147,8 +145,13 @@ Client::Client(
         rel_policy.kind = ::fastdds::dds::RELIABLE_RELIABILITY_QOS;
         datareader_qos.reliability(rel_policy);
 
+        // Endpoints announced through static discovery are identified by their user defined ID
+        datareader_qos.endpoint().user_defined_id = participant->add_static_reader(
+            request_entities_.dds_topic, request_entities_.dds_subscriber, datareader_qos);
+
+        // When a WaitSet drives the reception, the listener is not set
         request_entities_.dds_datareader = request_entities_.dds_subscriber->create_datareader(
-            request_entities_.dds_topic, datareader_qos, this);
+            request_entities_.dds_topic, datareader_qos, nullptr == waitset_ ? this : nullptr);
 
         if (request_entities_.dds_datareader)
         {
@@ -170,16 +173,9 @@ Client::Client(
 
     // Create reply entities
     {
-        // Create DDS publisher
-        reply_entities_.dds_publisher = dds_participant->create_publisher(
-            ::fastdds::dds::PUBLISHER_QOS_DEFAULT);
-        if (reply_entities_.dds_publisher)
-        {
-            logger_ << utils::Logger::Level::DEBUG
-                    << "Created Fast DDS publisher for service '"
-                    << service_name << "' reply" << std::endl;
-        }
-        else
+        // Get the DDS publisher shared with the topics in the default partition
+        reply_entities_.dds_publisher = participant->get_dds_publisher(::fastdds::dds::PartitionQosPolicy());
+        if (!reply_entities_.dds_publisher)
         {
             std::ostringstream err;
             err << "Fast DDS publisher for service '"
@@ -228,6 +224,10 @@ Client::Client(
             datawriter_qos.properties().properties().emplace_back(std::move(instance_property));
         }
 
+        // Endpoints announced through static discovery are identified by their user defined ID
+        datawriter_qos.endpoint().user_defined_id = participant->add_static_writer(
+            reply_entities_.dds_topic, reply_entities_.dds_publisher, datawriter_qos);
+
         reply_entities_.dds_datawriter = reply_entities_.dds_publisher->create_datawriter(
             reply_entities_.dds_topic, datawriter_qos, this);
 
@@ -248,6 +248,12 @@ Client::Client(
             throw(DDSMiddlewareException(logger_, err.str()));
         }
     }
+
+    // Attached last, so that the WaitSet never dispatches to a Client whose construction failed
+    if (nullptr != waitset_)
+    {
+        waitset_->attach(request_entities_.dds_datareader, this);
+    }
 }
 
 Client::~Client()
@@ -255,6 +261,11 @@ Client::~Client()
     logger_ << utils::Logger::Level::INFO
             << "Waiting for current processing messages before quitting" << std::endl;
 
+    if (nullptr != waitset_)
+    {
+        waitset_->detach(request_entities_.dds_datareader);
+    }
+
     {
         std::unique_lock<std::mutex> lock(cleaner_mtx_);
         stop_cleaner_ = true;
@@ -279,7 +290,6 @@ Client::~Client()
             request_entities_.dds_topic, request_entities_.dds_datareader);
 
         request_entities_.dds_subscriber->delete_datareader(request_entities_.dds_datareader);
-        dds_participant->delete_subscriber(request_entities_.dds_subscriber);
 
         if (delete_topic)
         {
@@ -295,7 +305,6 @@ Client::~Client()
             reply_entities_.dds_topic, reply_entities_.dds_datawriter);
 
         reply_entities_.dds_publisher->delete_datawriter(reply_entities_.dds_datawriter);
-        dds_participant->delete_publisher(reply_entities_.dds_publisher);
 
         if (delete_topic)
         {
@@ -572,6 +581,11 @@ void Client::on_data_available(
 void Client::receive(
         fastrtps::rtps::SampleIdentity sample_id)
 {
+    if (nullptr != realtime_)
+    {
+        realtime_->configure_current_thread();
+    }
+
     {
         ::xtypes::DynamicData received(request_entities_.type);
 
@@ -20,6 +20,8 @@
 
 #include "DDSMiddlewareException.hpp"
 #include "Participant.hpp"
+#include "RealTime.hpp"
+#include "ReceptionWaitSet.hpp"
 
 #include <is/systemhandle/SystemHandle.hpp>
 #include <is/utils/Log.hpp>
@@ -41,6 +43,7 @@ namespace fastdds {
 /**
  * @brief Forward declarations.
  */
+class ConversionContext;
 struct NavigationNode;
 class Participant;
 
@@ -84,6 +87,9 @@ public:
      * @param[in] participant The associated *Integration Service* Participant, which holds the
      *            DDS entities that compose this Client.
      *
+     * @param[in] conversion The conversion context of the system, which keeps the
+     *            *Fast DDS* builders of its types.
+     *
      * @param[in] service_name The service name. It will produce two topics:
      *            `<service_name>_Request` and `<service_name>_Reply`.
      *
@@ -94,14 +100,22 @@ public:
      * @param[in] callback Callback that gets triggered when a client has made a request.
      *
      * @param[in] config Additional configuration that might be required to configure this Client.
+     *
+     * @param[in] waitset If not `nullptr`, the request DataReader is created without listener and its
+     *            events are handled from the threads of this ReceptionWaitSet.
+     *
+     * @param[in] realtime Optional real-time settings, applied to the reception threads.
      */
     Client(
             eprosima::is::sh::fastdds::Participant* participant,
+            ConversionContext* conversion,
             const std::string& service_name,
             const xtypes::DynamicType& request_type,
             const xtypes::DynamicType& reply_type,
             ServiceClientSystem::RequestCallback* callback,
-            const YAML::Node& config);
+            const YAML::Node& config,
+            ReceptionWaitSet* waitset = nullptr,
+            const RealTime* realtime = nullptr);
 
     // TODO(@jamoralp): use XML profile to create request subscriber / reply publisher?
 
@@ -206,6 +220,8 @@ private:
      * Class members.
      */
     Participant* participant_;
+    ReceptionWaitSet* waitset_;
+    const RealTime* realtime_;
     const std::string service_name_;
 
     struct RequestEntities
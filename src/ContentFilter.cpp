@@ -0,0 +1,752 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ContentFilter.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <optional>
+#include <stdexcept>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace fastdds {
+
+namespace {
+
+enum class TokenType
+{
+    IDENTIFIER,
+    INTEGER,
+    FLOAT,
+    STRING,
+    PARAMETER,
+    SYMBOL,
+    END
+};
+
+struct Token
+{
+    TokenType type;
+    std::string text;
+};
+
+struct Operand
+{
+    bool is_field;
+    std::size_t field;
+    ContentFilter::Value value;
+};
+
+std::string to_upper(
+        std::string text)
+{
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c)
+            {
+                return static_cast<char>(std::toupper(c));
+            });
+    return text;
+}
+
+std::vector<Token> tokenize(
+        const std::string& text)
+{
+    std::vector<Token> tokens;
+    std::size_t i = 0;
+
+    while (i < text.size())
+    {
+        const char c = text[i];
+
+        if (std::isspace(static_cast<unsigned char>(c)))
+        {
+            ++i;
+        }
+        else if (std::isalpha(static_cast<unsigned char>(c)) || '_' == c)
+        {
+            std::size_t begin = i;
+            while (i < text.size() && (std::isalnum(static_cast<unsigned char>(text[i]))
+                    || '_' == text[i] || '.' == text[i]))
+            {
+                ++i;
+            }
+            tokens.push_back({TokenType::IDENTIFIER, text.substr(begin, i - begin)});
+        }
+        else if (std::isdigit(static_cast<unsigned char>(c))
+                || ('.' == c && i + 1 < text.size() && std::isdigit(static_cast<unsigned char>(text[i + 1]))))
+        {
+            std::size_t begin = i;
+            bool is_float = false;
+            while (i < text.size() && std::isdigit(static_cast<unsigned char>(text[i])))
+            {
+                ++i;
+            }
+            if (i < text.size() && '.' == text[i])
+            {
+                is_float = true;
+                ++i;
+                while (i < text.size() && std::isdigit(static_cast<unsigned char>(text[i])))
+                {
+                    ++i;
+                }
+            }
+            if (i < text.size() && ('e' == text[i] || 'E' == text[i]))
+            {
+                is_float = true;
+                ++i;
+                if (i < text.size() && ('+' == text[i] || '-' == text[i]))
+                {
+                    ++i;
+                }
+                while (i < text.size() && std::isdigit(static_cast<unsigned char>(text[i])))
+                {
+                    ++i;
+                }
+            }
+            tokens.push_back({is_float ? TokenType::FLOAT : TokenType::INTEGER, text.substr(begin, i - begin)});
+        }
+        else if ('\'' == c)
+        {
+            std::string value;
+            ++i;
+            while (true)
+            {
+                if (i >= text.size())
+                {
+                    throw std::invalid_argument("unterminated string literal");
+                }
+                if ('\'' == text[i])
+                {
+                    // A doubled quote stands for a quote inside the literal
+                    if (i + 1 < text.size() && '\'' == text[i + 1])
+                    {
+                        value.push_back('\'');
+                        i += 2;
+                        continue;
+                    }
+                    ++i;
+                    break;
+                }
+                value.push_back(text[i++]);
+            }
+            tokens.push_back({TokenType::STRING, value});
+        }
+        else if ('%' == c)
+        {
+            std::size_t begin = ++i;
+            while (i < text.size() && std::isdigit(static_cast<unsigned char>(text[i])))
+            {
+                ++i;
+            }
+            if (begin == i)
+            {
+                throw std::invalid_argument("expected parameter index after '%'");
+            }
+            tokens.push_back({TokenType::PARAMETER, text.substr(begin, i - begin)});
+        }
+        else
+        {
+            const std::string two = text.substr(i, 2);
+            if ("<=" == two || ">=" == two || "<>" == two || "!=" == two)
+            {
+                tokens.push_back({TokenType::SYMBOL, two});
+                i += 2;
+            }
+            else if (std::string("=<>()-").find(c) != std::string::npos)
+            {
+                tokens.push_back({TokenType::SYMBOL, std::string(1, c)});
+                ++i;
+            }
+            else
+            {
+                throw std::invalid_argument(std::string("unexpected character '") + c + "'");
+            }
+        }
+    }
+
+    tokens.push_back({TokenType::END, ""});
+    return tokens;
+}
+
+std::optional<int> compare(
+        const ContentFilter::Value& left,
+        const ContentFilter::Value& right)
+{
+    const bool left_is_string = std::holds_alternative<std::string>(left);
+    const bool right_is_string = std::holds_alternative<std::string>(right);
+
+    if (left_is_string && right_is_string)
+    {
+        const int result = std::get<std::string>(left).compare(std::get<std::string>(right));
+        return (result > 0) - (result < 0);
+    }
+    else if (left_is_string || right_is_string)
+    {
+        return std::nullopt;
+    }
+
+    auto as_integer = [](const ContentFilter::Value& value) -> std::optional<int64_t>
+            {
+                if (std::holds_alternative<bool>(value))
+                {
+                    return std::get<bool>(value) ? 1 : 0;
+                }
+                else if (std::holds_alternative<int64_t>(value))
+                {
+                    return std::get<int64_t>(value);
+                }
+                return std::nullopt;
+            };
+
+    auto as_double = [&as_integer](const ContentFilter::Value& value)
+            {
+                if (std::holds_alternative<double>(value))
+                {
+                    return std::get<double>(value);
+                }
+                return static_cast<double>(*as_integer(value));
+            };
+
+    std::optional<int64_t> left_integer = as_integer(left);
+    std::optional<int64_t> right_integer = as_integer(right);
+    if (left_integer && right_integer)
+    {
+        return (*left_integer > *right_integer) - (*left_integer < *right_integer);
+    }
+
+    const double left_double = as_double(left);
+    const double right_double = as_double(right);
+    return (left_double > right_double) - (left_double < right_double);
+}
+
+// SQL LIKE matching, where '%' matches any sequence of characters and '_' any single character
+bool like(
+        const std::string& text,
+        const std::string& pattern)
+{
+    std::size_t t = 0;
+    std::size_t p = 0;
+    std::size_t backtrack_t = std::string::npos;
+    std::size_t backtrack_p = std::string::npos;
+
+    while (t < text.size())
+    {
+        if (p < pattern.size() && ('_' == pattern[p] || text[t] == pattern[p]))
+        {
+            ++t;
+            ++p;
+        }
+        else if (p < pattern.size() && '%' == pattern[p])
+        {
+            backtrack_p = p++;
+            backtrack_t = t;
+        }
+        else if (std::string::npos != backtrack_p)
+        {
+            p = backtrack_p + 1;
+            t = ++backtrack_t;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    while (p < pattern.size() && '%' == pattern[p])
+    {
+        ++p;
+    }
+
+    return p == pattern.size();
+}
+
+} //  anonymous namespace
+
+struct ContentFilter::Node
+{
+    enum class Type
+    {
+        AND,
+        OR,
+        NOT,
+        COMPARE,
+        LIKE,
+        BETWEEN
+    };
+
+    Type type;
+    std::string op;
+    std::unique_ptr<Node> left;
+    std::unique_ptr<Node> right;
+    std::vector<Operand> operands;
+
+    bool evaluate(
+            const FieldReader& reader,
+            const std::vector<Path>& fields) const
+    {
+        switch (type)
+        {
+            case Type::AND:
+                return left->evaluate(reader, fields) && right->evaluate(reader, fields);
+            case Type::OR:
+                return left->evaluate(reader, fields) || right->evaluate(reader, fields);
+            case Type::NOT:
+                return !left->evaluate(reader, fields);
+            default:
+                break;
+        }
+
+        std::vector<Value> values(operands.size());
+        for (std::size_t i = 0; i < operands.size(); ++i)
+        {
+            if (!operands[i].is_field)
+            {
+                values[i] = operands[i].value;
+            }
+            else if (!reader(fields[operands[i].field], values[i]))
+            {
+                return false;
+            }
+        }
+
+        if (Type::LIKE == type)
+        {
+            return std::holds_alternative<std::string>(values[0])
+                   && std::holds_alternative<std::string>(values[1])
+                   && like(std::get<std::string>(values[0]), std::get<std::string>(values[1]));
+        }
+        else if (Type::BETWEEN == type)
+        {
+            std::optional<int> lower = compare(values[0], values[1]);
+            std::optional<int> upper = compare(values[0], values[2]);
+            return lower && upper && 0 <= *lower && 0 >= *upper;
+        }
+
+        std::optional<int> result = compare(values[0], values[1]);
+        if (!result)
+        {
+            return false;
+        }
+        else if ("=" == op)
+        {
+            return 0 == *result;
+        }
+        else if ("<>" == op || "!=" == op)
+        {
+            return 0 != *result;
+        }
+        else if ("<" == op)
+        {
+            return 0 > *result;
+        }
+        else if ("<=" == op)
+        {
+            return 0 >= *result;
+        }
+        else if (">" == op)
+        {
+            return 0 < *result;
+        }
+        return 0 <= *result;
+    }
+
+    void set_enumerators(
+            std::size_t field,
+            const Enumerators& enumerators)
+    {
+        if (left)
+        {
+            left->set_enumerators(field, enumerators);
+        }
+        if (right)
+        {
+            right->set_enumerators(field, enumerators);
+        }
+
+        auto is_field = [field](const Operand& operand)
+                {
+                    return operand.is_field && field == operand.field;
+                };
+        if (operands.end() == std::find_if(operands.begin(), operands.end(), is_field))
+        {
+            return;
+        }
+
+        if (Type::LIKE == type)
+        {
+            throw std::invalid_argument("enumeration fields cannot be matched with LIKE");
+        }
+
+        for (Operand& operand : operands)
+        {
+            if (!operand.is_field && std::holds_alternative<std::string>(operand.value))
+            {
+                const std::string& name = std::get<std::string>(operand.value);
+                auto it = enumerators.find(name);
+                if (enumerators.end() == it)
+                {
+                    throw std::invalid_argument("'" + name + "' is not an enumerator of the compared field");
+                }
+                operand.value = it->second;
+            }
+        }
+    }
+
+};
+
+/**
+ * Recursive descent parser of the filter expression:
+ *
+ *     condition  := term ( OR term )*
+ *     term       := factor ( AND factor )*
+ *     factor     := NOT factor | '(' condition ')' | predicate
+ *     predicate  := operand ( op operand | LIKE operand | BETWEEN operand AND operand )
+ *     operand    := field | literal | parameter
+ */
+class ContentFilter::Parser
+{
+public:
+
+    Parser(
+            const std::vector<Token>& tokens,
+            const std::vector<Value>& parameters,
+            std::vector<Path>& fields)
+        : tokens_(tokens)
+        , parameters_(parameters)
+        , fields_(fields)
+        , position_(0)
+    {
+    }
+
+    std::unique_ptr<Node> parse()
+    {
+        std::unique_ptr<Node> root = condition();
+        if (TokenType::END != current().type)
+        {
+            throw std::invalid_argument("unexpected '" + current().text + "'");
+        }
+        return root;
+    }
+
+    static Value literal(
+            const std::vector<Token>& tokens,
+            std::size_t& position)
+    {
+        bool negative = false;
+        if (TokenType::SYMBOL == tokens[position].type && "-" == tokens[position].text)
+        {
+            negative = true;
+            ++position;
+        }
+
+        const Token& token = tokens[position];
+        if (TokenType::INTEGER == token.type)
+        {
+            ++position;
+            try
+            {
+                int64_t value = std::stoll(token.text);
+                return negative ? -value : value;
+            }
+            catch (const std::out_of_range&)
+            {
+                double value = std::stod(token.text);
+                return negative ? -value : value;
+            }
+        }
+        else if (TokenType::FLOAT == token.type)
+        {
+            ++position;
+            double value = std::stod(token.text);
+            return negative ? -value : value;
+        }
+        else if (!negative && TokenType::STRING == token.type)
+        {
+            ++position;
+            return token.text;
+        }
+        else if (!negative && TokenType::IDENTIFIER == token.type)
+        {
+            const std::string keyword = to_upper(token.text);
+            if ("TRUE" == keyword || "FALSE" == keyword)
+            {
+                ++position;
+                return "TRUE" == keyword;
+            }
+        }
+
+        throw std::invalid_argument("expected a literal value, found '" + token.text + "'");
+    }
+
+private:
+
+    const Token& current() const
+    {
+        return tokens_[position_];
+    }
+
+    bool accept_keyword(
+            const std::string& keyword)
+    {
+        if (TokenType::IDENTIFIER == current().type && keyword == to_upper(current().text))
+        {
+            ++position_;
+            return true;
+        }
+        return false;
+    }
+
+    bool accept_symbol(
+            const std::string& symbol)
+    {
+        if (TokenType::SYMBOL == current().type && symbol == current().text)
+        {
+            ++position_;
+            return true;
+        }
+        return false;
+    }
+
+    std::unique_ptr<Node> binary(
+            Node::Type type,
+            std::unique_ptr<Node> left,
+            std::unique_ptr<Node> right)
+    {
+        std::unique_ptr<Node> node(new Node{type, "", std::move(left), std::move(right), {}});
+        return node;
+    }
+
+    std::unique_ptr<Node> condition()
+    {
+        std::unique_ptr<Node> node = term();
+        while (accept_keyword("OR"))
+        {
+            node = binary(Node::Type::OR, std::move(node), term());
+        }
+        return node;
+    }
+
+    std::unique_ptr<Node> term()
+    {
+        std::unique_ptr<Node> node = factor();
+        while (accept_keyword("AND"))
+        {
+            node = binary(Node::Type::AND, std::move(node), factor());
+        }
+        return node;
+    }
+
+    std::unique_ptr<Node> factor()
+    {
+        if (accept_keyword("NOT"))
+        {
+            return binary(Node::Type::NOT, factor(), nullptr);
+        }
+        else if (accept_symbol("("))
+        {
+            std::unique_ptr<Node> node = condition();
+            if (!accept_symbol(")"))
+            {
+                throw std::invalid_argument("expected ')', found '" + current().text + "'");
+            }
+            return node;
+        }
+        return predicate();
+    }
+
+    std::unique_ptr<Node> predicate()
+    {
+        std::unique_ptr<Node> node(new Node{Node::Type::COMPARE, "", nullptr, nullptr, {}});
+        node->operands.push_back(operand());
+
+        if (accept_keyword("LIKE"))
+        {
+            node->type = Node::Type::LIKE;
+            node->operands.push_back(operand());
+        }
+        else if (accept_keyword("BETWEEN"))
+        {
+            node->type = Node::Type::BETWEEN;
+            node->operands.push_back(operand());
+            if (!accept_keyword("AND"))
+            {
+                throw std::invalid_argument("expected 'AND' in 'BETWEEN', found '" + current().text + "'");
+            }
+            node->operands.push_back(operand());
+        }
+        else
+        {
+            static const std::vector<std::string> operators = {"=", "<>", "!=", "<", "<=", ">", ">="};
+            if (TokenType::SYMBOL != current().type
+                    || operators.end() == std::find(operators.begin(), operators.end(), current().text))
+            {
+                throw std::invalid_argument("expected a comparison operator, found '" + current().text + "'");
+            }
+            node->op = tokens_[position_++].text;
+            node->operands.push_back(operand());
+        }
+
+        return node;
+    }
+
+    Operand operand()
+    {
+        const Token& token = current();
+
+        if (TokenType::PARAMETER == token.type)
+        {
+            const std::size_t index = std::stoul(token.text);
+            if (index >= parameters_.size())
+            {
+                throw std::invalid_argument("parameter %" + token.text + " is not defined");
+            }
+            ++position_;
+            return Operand{false, 0, parameters_[index]};
+        }
+
+        const std::string keyword = to_upper(token.text);
+        if (TokenType::IDENTIFIER == token.type && "TRUE" != keyword && "FALSE" != keyword)
+        {
+            static const std::vector<std::string> reserved = {"AND", "OR", "NOT", "LIKE", "BETWEEN"};
+            if (reserved.end() != std::find(reserved.begin(), reserved.end(), keyword))
+            {
+                throw std::invalid_argument("expected an operand, found '" + token.text + "'");
+            }
+
+            ++position_;
+            return Operand{true, field(token.text), Value()};
+        }
+
+        return Operand{false, 0, literal(tokens_, position_)};
+    }
+
+    std::size_t field(
+            const std::string& name)
+    {
+        Path path;
+        std::size_t begin = 0;
+        while (true)
+        {
+            std::size_t end = name.find('.', begin);
+            path.push_back(name.substr(begin, end - begin));
+            if (path.back().empty())
+            {
+                throw std::invalid_argument("invalid field name '" + name + "'");
+            }
+            if (std::string::npos == end)
+            {
+                break;
+            }
+            begin = end + 1;
+        }
+
+        auto it = std::find(fields_.begin(), fields_.end(), path);
+        if (fields_.end() != it)
+        {
+            return static_cast<std::size_t>(it - fields_.begin());
+        }
+
+        fields_.push_back(std::move(path));
+        return fields_.size() - 1;
+    }
+
+    const std::vector<Token>& tokens_;
+    const std::vector<Value>& parameters_;
+    std::vector<Path>& fields_;
+    std::size_t position_;
+};
+
+ContentFilter::ContentFilter(
+        const std::string& expression,
+        const std::vector<std::string>& parameters)
+    : expression_(expression)
+    , parameters_(parameters)
+    , logger_("is::sh::FastDDS::ContentFilter")
+{
+    try
+    {
+        std::vector<Value> values;
+        for (const std::string& parameter : parameters)
+        {
+            std::vector<Token> tokens = tokenize(parameter);
+            std::size_t position = 0;
+            values.push_back(Parser::literal(tokens, position));
+            if (TokenType::END != tokens[position].type)
+            {
+                throw std::invalid_argument("parameter \"" + parameter + "\" is not a single literal value");
+            }
+        }
+
+        std::vector<Token> tokens = tokenize(expression);
+        root_ = Parser(tokens, values, fields_).parse();
+    }
+    catch (const std::logic_error& e)
+    {
+        throw DDSMiddlewareException(
+                  logger_, "Invalid filter expression '" + expression + "': " + e.what());
+    }
+}
+
+ContentFilter::~ContentFilter() = default;
+
+void ContentFilter::set_enumerators(
+        const Path& path,
+        const Enumerators& enumerators)
+{
+    auto it = std::find(fields_.begin(), fields_.end(), path);
+    if (fields_.end() == it)
+    {
+        return;
+    }
+
+    try
+    {
+        root_->set_enumerators(static_cast<std::size_t>(it - fields_.begin()), enumerators);
+    }
+    catch (const std::logic_error& e)
+    {
+        throw DDSMiddlewareException(
+                  logger_, "Invalid filter expression '" + expression_ + "': " + e.what());
+    }
+}
+
+bool ContentFilter::evaluate(
+        const FieldReader& reader) const
+{
+    return root_->evaluate(reader, fields_);
+}
+
+const std::string& ContentFilter::expression() const
+{
+    return expression_;
+}
+
+const std::vector<std::string>& ContentFilter::parameters() const
+{
+    return parameters_;
+}
+
+const std::vector<ContentFilter::Path>& ContentFilter::fields() const
+{
+    return fields_;
+}
+
+} //  namespace fastdds
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
@@ -0,0 +1,158 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _IS_SH_FASTDDS__INTERNAL__CONTENTFILTER_HPP_
+#define _IS_SH_FASTDDS__INTERNAL__CONTENTFILTER_HPP_
+
+#include "DDSMiddlewareException.hpp"
+
+#include <is/utils/Log.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace fastdds {
+
+/**
+ * @class ContentFilter
+ *        Evaluates a DDS SQL-like filter expression on the samples of a topic, so that samples
+ *        which are not wanted can be discarded before being converted.
+ *
+ * @details The supported grammar is the subset of the DDS content filter grammar made of
+ *          comparisons (`=`, `<>`, `!=`, `<`, `<=`, `>`, `>=`, `LIKE` and `BETWEEN`) between
+ *          fields, literals and parameters (`%0`, `%1`...), combined with `AND`, `OR`, `NOT`
+ *          and parentheses. Nested fields are written with dots, e.g. `pose.position.x > 0`.
+ *
+ *          The field values are obtained, on each evaluation, through a FieldReader, so this
+ *          class does not depend on any particular data representation.
+ */
+class ContentFilter
+{
+public:
+
+    /**
+     * @brief Value of a field, literal or parameter.
+     */
+    using Value = std::variant<bool, int64_t, double, std::string>;
+
+    /**
+     * @brief Path of a field, made of the member names from the topic type to the field.
+     */
+    using Path = std::vector<std::string>;
+
+    /**
+     * @brief Reads the value of a field from the sample being evaluated.
+     *        Returns `false` if the field cannot be read.
+     */
+    using FieldReader = std::function<bool (const Path& path, Value& value)>;
+
+    /**
+     * @brief Values of the enumerators of an enumeration field, by name.
+     */
+    using Enumerators = std::map<std::string, int64_t>;
+
+    /**
+     * @brief Construct a new ContentFilter object, parsing the filter expression.
+     *
+     * @param[in] expression The filter expression.
+     *
+     * @param[in] parameters The values of the `%N` parameters, written as literals.
+     *
+     * @throws DDSMiddlewareException If the expression or some parameter is not valid.
+     */
+    ContentFilter(
+            const std::string& expression,
+            const std::vector<std::string>& parameters = {});
+
+    /**
+     * @brief Destroy the ContentFilter object.
+     */
+    ~ContentFilter();
+
+    /**
+     * @brief Declare a field as an enumeration, so that the string literals and parameters
+     *        compared with it, such as `'RED'` in `color = 'RED'`, stand for the value of the
+     *        enumerator they name. Fields are read as the integer value of their enumerator.
+     *
+     * @param[in] path The enumeration field.
+     *
+     * @param[in] enumerators The enumerators of the field type.
+     *
+     * @throws DDSMiddlewareException If some string compared with the field is not an enumerator,
+     *         or the field is matched with `LIKE`.
+     */
+    void set_enumerators(
+            const Path& path,
+            const Enumerators& enumerators);
+
+    /**
+     * @brief Evaluate the filter on a sample.
+     *
+     * @param[in] reader Reads the fields of the sample. A comparison involving a field that
+     *            cannot be read, or values that cannot be compared, is false.
+     *
+     * @returns `true` if the sample passes the filter.
+     */
+    bool evaluate(
+            const FieldReader& reader) const;
+
+    /**
+     * @brief Get the filter expression.
+     */
+    const std::string& expression() const;
+
+    /**
+     * @brief Get the filter parameters.
+     */
+    const std::vector<std::string>& parameters() const;
+
+    /**
+     * @brief Get every field referenced by the expression, so that they can be validated
+     *        against the topic type.
+     */
+    const std::vector<Path>& fields() const;
+
+private:
+
+    struct Node;
+    class Parser;
+
+    /**
+     * Class members.
+     */
+    std::string expression_;
+    std::vector<std::string> parameters_;
+    std::vector<Path> fields_;
+    std::unique_ptr<Node> root_;
+
+    utils::Logger logger_;
+};
+
+} //  namespace fastdds
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+#endif //  _IS_SH_FASTDDS__INTERNAL__CONTENTFILTER_HPP_
@@ -22,6 +22,7 @@
 #include <fastrtps/types/DynamicTypeBuilderFactory.h>
 #include <fastrtps/types/MemberDescriptor.h>
 
+#include <limits>
 #include <sstream>
 #include <stack>
 
@@ -38,9 +39,6 @@ namespace xtypes = eprosima::xtypes;
 using namespace eprosima::fastrtps;
 using namespace eprosima::fastrtps::types;
 
-std::map<std::string, ::xtypes::DynamicType::Ptr> Conversion::types_;
-std::map<std::string, DynamicPubSubType*> Conversion::registered_types_;
-std::map<std::string, DynamicTypeBuilder_ptr> Conversion::builders_;
 
 // Static member initialization
 utils::Logger NavigationNode::logger_("is::sh::FastDDS::Conversion::NavigationNode");
@@ -909,11 +907,12 @@ void Conversion::set_map_data(
 
 bool Conversion::xtypes_to_fastdds(
         const ::xtypes::DynamicData& input,
-        DynamicData* output)
+        DynamicData* output,
+        const Projection* projection)
 {
     if (input.type().kind() == ::xtypes::TypeKind::STRUCTURE_TYPE)
     {
-        return set_struct_data(input, output);
+        return set_struct_data(input, output, projection);
     }
     else if (input.type().kind() == ::xtypes::TypeKind::UNION_TYPE)
     {
@@ -928,7 +927,8 @@ bool Conversion::xtypes_to_fastdds(
 
 bool Conversion::set_struct_data(
         ::xtypes::ReadableDynamicDataRef input,
-        DynamicData* output)
+        DynamicData* output,
+        const Projection* projection)
 {
     std::stringstream ss;
 
@@ -936,6 +936,17 @@ bool Conversion::set_struct_data(
 
     for (const ::xtypes::Member& member : type.members())
     {
+        const Projection* member_projection = nullptr;
+        if (nullptr != projection && !projection->members.empty())
+        {
+            auto it = projection->members.find(member.name());
+            if (projection->members.end() == it)
+            {
+                continue;
+            }
+            member_projection = it->second.get();
+        }
+
         MemberId id = output->get_member_id_by_name(member.name());
         switch (resolve_type(member.type()).kind())
         {
@@ -985,7 +996,7 @@ bool Conversion::set_struct_data(
             case ::xtypes::TypeKind::STRUCTURE_TYPE:
             {
                 DynamicData* st_data = output->loan_value(id);
-                set_struct_data(input[member.name()], st_data);
+                set_struct_data(input[member.name()], st_data, member_projection);
                 output->return_loaned_value(st_data);
                 break;
             }
@@ -1940,11 +1951,12 @@ void Conversion::set_array_data(
 // TODO: Can we receive a type without members as root?
 bool Conversion::fastdds_to_xtypes(
         const DynamicData* c_input,
-        ::xtypes::DynamicData& output)
+        ::xtypes::DynamicData& output,
+        const Projection* projection)
 {
     if (output.type().kind() == ::xtypes::TypeKind::STRUCTURE_TYPE)
     {
-        return set_struct_data(c_input, output.ref());
+        return set_struct_data(c_input, output.ref(), projection);
     }
     else if (output.type().kind() == ::xtypes::TypeKind::UNION_TYPE)
     {
@@ -1970,7 +1982,8 @@ TypeKind Conversion::resolve_type(
 
 bool Conversion::set_struct_data(
         const DynamicData* c_input,
-        ::xtypes::WritableDynamicDataRef output)
+        ::xtypes::WritableDynamicDataRef output,
+        const Projection* projection)
 {
     std::stringstream ss;
     uint32_t id = 0;
@@ -1989,6 +2002,19 @@ bool Conversion::set_struct_data(
         {
             ret = input->get_descriptor(descriptor, id);
 
+            const Projection* member_projection = nullptr;
+            if (ret == ResponseCode::RETCODE_OK && nullptr != projection && !projection->members.empty())
+            {
+                auto it = projection->members.find(descriptor.get_name());
+                if (projection->members.end() == it)
+                {
+                    // Not selected, leave the default value
+                    i++;
+                    continue;
+                }
+                member_projection = it->second.get();
+            }
+
             if (ret == ResponseCode::RETCODE_OK)
             {
                 switch (resolve_type(descriptor.get_type()))
@@ -2147,7 +2173,7 @@ bool Conversion::set_struct_data(
 
                         if (nested_msg_dds != nullptr)
                         {
-                            if (set_struct_data(nested_msg_dds, output[descriptor.get_name()]))
+                            if (set_struct_data(nested_msg_dds, output[descriptor.get_name()], member_projection))
                             {
                                 ret = ResponseCode::RETCODE_OK;
                             }
@@ -2392,42 +2418,499 @@ bool Conversion::set_union_data(
     return true;
 }
 
-::xtypes::DynamicData Conversion::dynamic_data(
-        const std::string& type_name)
+bool Conversion::is_bounded(
+        const ::xtypes::DynamicType& type)
+{
+    const ::xtypes::DynamicType& resolved = resolve_type(type);
+    switch (resolved.kind())
+    {
+        case ::xtypes::TypeKind::STRING_TYPE:
+            return 0 < static_cast<const ::xtypes::StringType&>(resolved).bounds();
+        case ::xtypes::TypeKind::WSTRING_TYPE:
+            return 0 < static_cast<const ::xtypes::WStringType&>(resolved).bounds();
+        case ::xtypes::TypeKind::ARRAY_TYPE:
+            return is_bounded(static_cast<const ::xtypes::ArrayType&>(resolved).content_type());
+        case ::xtypes::TypeKind::SEQUENCE_TYPE:
+        {
+            const ::xtypes::SequenceType& c_type = static_cast<const ::xtypes::SequenceType&>(resolved);
+            return 0 < c_type.bounds() && is_bounded(c_type.content_type());
+        }
+        case ::xtypes::TypeKind::MAP_TYPE:
+        {
+            const ::xtypes::MapType& c_type = static_cast<const ::xtypes::MapType&>(resolved);
+            const ::xtypes::PairType& content_type = static_cast<const ::xtypes::PairType&>(c_type.content_type());
+            return 0 < c_type.bounds() && is_bounded(content_type.first()) && is_bounded(content_type.second());
+        }
+        case ::xtypes::TypeKind::UNION_TYPE:
+        {
+            const ::xtypes::UnionType& c_type = static_cast<const ::xtypes::UnionType&>(resolved);
+            for (const std::string& member_name : c_type.get_case_members())
+            {
+                if (!is_bounded(c_type.member(member_name).type()))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case ::xtypes::TypeKind::STRUCTURE_TYPE:
+        {
+            const ::xtypes::StructType& c_type = static_cast<const ::xtypes::StructType&>(resolved);
+            for (size_t idx = 0; idx < c_type.members().size(); ++idx)
+            {
+                if (!is_bounded(c_type.member(idx).type()))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+        default:
+            // Primitives and enumerations
+            return true;
+    }
+}
+
+std::string Conversion::fingerprint(
+        const ::xtypes::DynamicType& type,
+        ConversionContext* context)
 {
-    auto it = types_.find(type_name);
+    if (nullptr != context)
+    {
+        // Nested types are fingerprinted again for every type that contains them
+        std::shared_lock<std::shared_mutex> lock(context->builders_mtx_);
+        auto it = context->fingerprints_.find(&type);
+        if (context->fingerprints_.end() != it)
+        {
+            return it->second;
+        }
+    }
 
-    if (it == types_.end())
+    const ::xtypes::DynamicType& resolved = resolve_type(type);
+    std::ostringstream fp;
+    switch (resolved.kind())
     {
-        logger_ << utils::Logger::Level::ERROR
-                << "Error getting data from dynamic type '"
-                << type_name << "' (not registered)" << std::endl;
+        case ::xtypes::TypeKind::STRING_TYPE:
+        {
+            fp << "string<" << static_cast<const ::xtypes::StringType&>(resolved).bounds() << ">";
+            break;
+        }
+        case ::xtypes::TypeKind::WSTRING_TYPE:
+        {
+            fp << "wstring<" << static_cast<const ::xtypes::WStringType&>(resolved).bounds() << ">";
+            break;
+        }
+        case ::xtypes::TypeKind::ENUMERATION_TYPE:
+        {
+            const ::xtypes::EnumerationType<uint32_t>& c_type =
+                    static_cast<const ::xtypes::EnumerationType<uint32_t>&>(resolved);
+            fp << "enum{";
+            for (const auto& pair : c_type.enumerators())
+            {
+                fp << pair.first << "=" << pair.second << ";";
+            }
+            fp << "}";
+            break;
+        }
+        case ::xtypes::TypeKind::ARRAY_TYPE:
+        {
+            const ::xtypes::ArrayType& c_type = static_cast<const ::xtypes::ArrayType&>(resolved);
+            fp << "array<" << fingerprint(c_type.content_type(), context) << "," << c_type.dimension() << ">";
+            break;
+        }
+        case ::xtypes::TypeKind::SEQUENCE_TYPE:
+        {
+            const ::xtypes::SequenceType& c_type = static_cast<const ::xtypes::SequenceType&>(resolved);
+            fp << "sequence<" << fingerprint(c_type.content_type(), context) << "," << c_type.bounds() << ">";
+            break;
+        }
+        case ::xtypes::TypeKind::MAP_TYPE:
+        {
+            const ::xtypes::MapType& c_type = static_cast<const ::xtypes::MapType&>(resolved);
+            const ::xtypes::PairType& content_type = static_cast<const ::xtypes::PairType&>(c_type.content_type());
+            fp << "map<" << fingerprint(content_type.first(), context) << ","
+               << fingerprint(content_type.second(), context) << "," << c_type.bounds() << ">";
+            break;
+        }
+        case ::xtypes::TypeKind::UNION_TYPE:
+        {
+            const ::xtypes::UnionType& c_type = static_cast<const ::xtypes::UnionType&>(resolved);
+            fp << "union<" << fingerprint(c_type.discriminator(), context) << ">{";
+            for (const std::string& member_name : c_type.get_case_members())
+            {
+                fp << (c_type.is_default(member_name) ? "default," : "");
+                for (int64_t label : c_type.get_labels(member_name))
+                {
+                    fp << label << ",";
+                }
+                fp << member_name << ":" << fingerprint(c_type.member(member_name).type(), context) << ";";
+            }
+            fp << "}";
+            break;
+        }
+        case ::xtypes::TypeKind::STRUCTURE_TYPE:
+        {
+            const ::xtypes::StructType& c_type = static_cast<const ::xtypes::StructType&>(resolved);
+            fp << "struct{";
+            for (size_t idx = 0; idx < c_type.members().size(); ++idx)
+            {
+                const ::xtypes::Member& member = c_type.member(idx);
+                fp << member.name() << ":" << fingerprint(member.type(), context) << ";";
+            }
+            fp << "}";
+            break;
+        }
+        default:
+        {
+            // Primitives are identified by their kind
+            fp << static_cast<uint32_t>(resolved.kind());
+            break;
+        }
     }
 
-    return ::xtypes::DynamicData(*it->second.get());
+    if (nullptr != context)
+    {
+        std::unique_lock<std::shared_mutex> lock(context->builders_mtx_);
+        return context->fingerprints_.emplace(&type, fp.str()).first->second;
+    }
+    return fp.str();
 }
 
-DynamicTypeBuilder* Conversion::create_builder(
-        const ::xtypes::DynamicType& type)
+std::shared_ptr<Projection> Conversion::create_projection(
+        const ::xtypes::DynamicType& type,
+        const std::vector<std::string>& fields)
+{
+    std::shared_ptr<Projection> root = std::make_shared<Projection>();
+
+    for (const std::string& field : fields)
+    {
+        const ::xtypes::DynamicType* current = &resolve_type(type);
+        Projection* node = root.get();
+        std::string path;
+        bool already_selected = false;
+
+        std::stringstream ss(field);
+        std::string member_name;
+        while (std::getline(ss, member_name, '.'))
+        {
+            path += (path.empty() ? "" : ".") + member_name;
+
+            if (::xtypes::TypeKind::STRUCTURE_TYPE != current->kind()
+                    || !static_cast<const ::xtypes::StructType&>(*current).has_member(member_name))
+            {
+                throw DDSMiddlewareException(
+                          logger_, "Field '" + path + "' does not exist in type '" + type.name() + "'");
+            }
+
+            current = &resolve_type(
+                static_cast<const ::xtypes::StructType&>(*current).member(member_name).type());
+
+            std::shared_ptr<Projection>& child = node->members[member_name];
+            if (child && child->members.empty())
+            {
+                // The whole member was already selected
+                already_selected = true;
+                break;
+            }
+            else if (!child)
+            {
+                child = std::make_shared<Projection>();
+            }
+            node = child.get();
+        }
+
+        if (path.empty())
+        {
+            throw DDSMiddlewareException(logger_, "Empty field in projection of type '" + type.name() + "'");
+        }
+
+        if (!already_selected)
+        {
+            // A field selects the whole member, even if some of its members were selected before
+            node->members.clear();
+        }
+    }
+
+    return root;
+}
+
+bool Conversion::is_filterable_member(
+        const ::xtypes::DynamicType& type,
+        const ContentFilter::Path& path)
 {
-    if (builders_.count(type.name()) > 0)
+    const ::xtypes::DynamicType* current = &resolve_type(type);
+    for (const std::string& member_name : path)
     {
-        return static_cast<DynamicTypeBuilder*>(builders_[type.name()].get());
+        if (::xtypes::TypeKind::STRUCTURE_TYPE != current->kind())
+        {
+            return false;
+        }
+
+        const ::xtypes::StructType& struct_type = static_cast<const ::xtypes::StructType&>(*current);
+        if (!struct_type.has_member(member_name))
+        {
+            return false;
+        }
+        current = &resolve_type(struct_type.member(member_name).type());
     }
 
-    DynamicTypeBuilder_ptr builder = get_builder(type);
-    if (builder == nullptr)
+    return current->is_primitive_type()
+           || ::xtypes::TypeKind::STRING_TYPE == current->kind()
+           || ::xtypes::TypeKind::WSTRING_TYPE == current->kind()
+           || ::xtypes::TypeKind::ENUMERATION_TYPE == current->kind();
+}
+
+namespace {
+
+// Encodes a wide string as UTF-8, the encoding of the filter expressions
+std::string to_utf8(
+        const std::wstring& text)
+{
+    std::string result;
+    for (std::size_t i = 0; i < text.size(); ++i)
     {
-        return nullptr;
+        uint32_t code = static_cast<uint32_t>(text[i]);
+
+        // 16 bits wide characters hold UTF-16, whose surrogate pairs encode a single code point
+        if (2 == sizeof(wchar_t) && 0xD800 <= code && code < 0xDC00 && i + 1 < text.size())
+        {
+            const uint32_t low = static_cast<uint32_t>(text[i + 1]);
+            if (0xDC00 <= low && low < 0xE000)
+            {
+                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                ++i;
+            }
+        }
+
+        if (code < 0x80)
+        {
+            result.push_back(static_cast<char>(code));
+        }
+        else if (code < 0x800)
+        {
+            result.push_back(static_cast<char>(0xC0 | (code >> 6)));
+            result.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+        else if (code < 0x10000)
+        {
+            result.push_back(static_cast<char>(0xE0 | (code >> 12)));
+            result.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            result.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+        else
+        {
+            result.push_back(static_cast<char>(0xF0 | ((code >> 18) & 0x07)));
+            result.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+            result.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            result.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
     }
-    DynamicTypeBuilder* result = static_cast<DynamicTypeBuilder*>(builder.get());
-    result->set_name(convert_type_name(type.name()));
-    builders_.emplace(type.name(), std::move(builder));
     return result;
 }
 
+} //  anonymous namespace
+
+bool Conversion::get_enumerators(
+        const ::xtypes::DynamicType& type,
+        const ContentFilter::Path& path,
+        ContentFilter::Enumerators& enumerators)
+{
+    const ::xtypes::DynamicType* current = &resolve_type(type);
+    for (const std::string& member_name : path)
+    {
+        if (::xtypes::TypeKind::STRUCTURE_TYPE != current->kind()
+                || !static_cast<const ::xtypes::StructType*>(current)->has_member(member_name))
+        {
+            return false;
+        }
+        current = &resolve_type(static_cast<const ::xtypes::StructType*>(current)->member(member_name).type());
+    }
+
+    if (::xtypes::TypeKind::ENUMERATION_TYPE != current->kind())
+    {
+        return false;
+    }
+
+    enumerators.clear();
+    for (const auto& pair : static_cast<const ::xtypes::EnumerationType<uint32_t>*>(current)->enumerators())
+    {
+        enumerators.emplace(pair.first, static_cast<int64_t>(pair.second));
+    }
+    return true;
+}
+
+bool Conversion::fastdds_member_value(
+        const DynamicData* c_input,
+        const ContentFilter::Path& path,
+        ContentFilter::Value& value)
+{
+    // We promise to not modify it, but we need it non-const, so we can call loan_value freely.
+    DynamicData* input = const_cast<DynamicData*>(c_input);
+    std::vector<std::pair<DynamicData*, DynamicData*> > loans;
+    ResponseCode ret = ResponseCode::RETCODE_ERROR;
+
+    for (size_t i = 0; i < path.size(); ++i)
+    {
+        MemberId id = input->get_member_id_by_name(path[i]);
+        MemberDescriptor descriptor;
+        if (MEMBER_ID_INVALID == id || ResponseCode::RETCODE_OK != input->get_descriptor(descriptor, id))
+        {
+            ret = ResponseCode::RETCODE_ERROR;
+            break;
+        }
+
+        const TypeKind kind = resolve_type(descriptor.get_type());
+
+        if (i + 1 < path.size())
+        {
+            DynamicData* nested = types::TK_STRUCTURE == kind ? input->loan_value(id) : nullptr;
+            if (nullptr == nested)
+            {
+                ret = ResponseCode::RETCODE_ERROR;
+                break;
+            }
+            loans.emplace_back(input, nested);
+            input = nested;
+            continue;
+        }
+
+        switch (kind)
+        {
+            case types::TK_BOOLEAN:
+            {
+                bool v;
+                ret = input->get_bool_value(v, id);
+                value = v;
+                break;
+            }
+            case types::TK_BYTE:
+            {
+                uint8_t v;
+                ret = input->get_byte_value(v, id);
+                value = static_cast<int64_t>(v);
+                break;
+            }
+            case types::TK_INT16:
+            {
+                int16_t v;
+                ret = input->get_int16_value(v, id);
+                value = static_cast<int64_t>(v);
+                break;
+            }
+            case types::TK_INT32:
+            {
+                int32_t v;
+                ret = input->get_int32_value(v, id);
+                value = static_cast<int64_t>(v);
+                break;
+            }
+            case types::TK_INT64:
+            {
+                int64_t v;
+                ret = input->get_int64_value(v, id);
+                value = v;
+                break;
+            }
+            case types::TK_UINT16:
+            {
+                uint16_t v;
+                ret = input->get_uint16_value(v, id);
+                value = static_cast<int64_t>(v);
+                break;
+            }
+            case types::TK_UINT32:
+            {
+                uint32_t v;
+                ret = input->get_uint32_value(v, id);
+                value = static_cast<int64_t>(v);
+                break;
+            }
+            case types::TK_UINT64:
+            {
+                uint64_t v;
+                ret = input->get_uint64_value(v, id);
+                if (v <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
+                {
+                    value = static_cast<int64_t>(v);
+                }
+                else
+                {
+                    value = static_cast<double>(v);
+                }
+                break;
+            }
+            case types::TK_FLOAT32:
+            {
+                float v;
+                ret = input->get_float32_value(v, id);
+                value = static_cast<double>(v);
+                break;
+            }
+            case types::TK_FLOAT64:
+            {
+                double v;
+                ret = input->get_float64_value(v, id);
+                value = v;
+                break;
+            }
+            case types::TK_FLOAT128:
+            {
+                long double v;
+                ret = input->get_float128_value(v, id);
+                value = static_cast<double>(v);
+                break;
+            }
+            case types::TK_CHAR8:
+            {
+                char v;
+                ret = input->get_char8_value(v, id);
+                value = std::string(1, v);
+                break;
+            }
+            case types::TK_CHAR16:
+            {
+                wchar_t v;
+                ret = input->get_char16_value(v, id);
+                value = static_cast<int64_t>(v);
+                break;
+            }
+            case types::TK_STRING8:
+            {
+                std::string v;
+                ret = input->get_string_value(v, id);
+                value = v;
+                break;
+            }
+            case types::TK_STRING16:
+            {
+                std::wstring v;
+                ret = input->get_wstring_value(v, id);
+                value = to_utf8(v);
+                break;
+            }
+            case types::TK_ENUM:
+            {
+                uint32_t v;
+                ret = input->get_enum_value(v, id);
+                value = static_cast<int64_t>(v);
+                break;
+            }
+            default:
+                ret = ResponseCode::RETCODE_ERROR;
+        }
+    }
+
+    for (auto it = loans.rbegin(); it != loans.rend(); ++it)
+    {
+        it->first->return_loaned_value(it->second);
+    }
+
+    return ResponseCode::RETCODE_OK == ret;
+}
+
 DynamicTypeBuilder_ptr Conversion::get_builder(
-        const ::xtypes::DynamicType& type)
+        const ::xtypes::DynamicType& type,
+        ConversionContext* context)
 {
     DynamicTypeBuilderFactory* factory = DynamicTypeBuilderFactory::get_instance();
     switch (type.kind())
@@ -2511,7 +2994,7 @@ DynamicTypeBuilder_ptr Conversion::get_builder(
                DynamicTypeBuilder* ptr = content.get();
                return factory->create_alias_type(ptr, type.name());
              */
-            return get_builder(static_cast<const ::xtypes::AliasType&>(type).rget()); // Resolve alias
+            return get_builder(static_cast<const ::xtypes::AliasType&>(type).rget(), context); // Resolve alias
         }
         /*
            case ::xtypes::TypeKind::BITMASK_TYPE:
@@ -2523,7 +3006,7 @@ DynamicTypeBuilder_ptr Conversion::get_builder(
         {
             const ::xtypes::ArrayType& c_type = static_cast<const ::xtypes::ArrayType&>(type);
             std::pair<std::vector<uint32_t>, DynamicTypeBuilder_ptr> pair;
-            get_array_specs(c_type, pair);
+            get_array_specs(c_type, pair, context);
             DynamicTypeBuilder* builder = static_cast<DynamicTypeBuilder*>(pair.second.get());
             DynamicTypeBuilder_ptr result = factory->create_array_builder(builder, pair.first);
             return result;
@@ -2531,7 +3014,7 @@ DynamicTypeBuilder_ptr Conversion::get_builder(
         case ::xtypes::TypeKind::SEQUENCE_TYPE:
         {
             const ::xtypes::SequenceType& c_type = static_cast<const ::xtypes::SequenceType&>(type);
-            DynamicTypeBuilder_ptr content = get_builder(c_type.content_type());
+            DynamicTypeBuilder_ptr content = get_member_builder(c_type.content_type(), context);
             DynamicTypeBuilder* builder = static_cast<DynamicTypeBuilder*>(content.get());
             DynamicTypeBuilder_ptr result = factory->create_sequence_builder(builder, c_type.bounds());
             return result;
@@ -2550,15 +3033,15 @@ DynamicTypeBuilder_ptr Conversion::get_builder(
         {
             const ::xtypes::MapType& c_type = static_cast<const ::xtypes::MapType&>(type);
             const ::xtypes::PairType& content_type = static_cast<const ::xtypes::PairType&>(c_type.content_type());
-            DynamicTypeBuilder_ptr key = get_builder(content_type.first());
-            DynamicTypeBuilder_ptr value = get_builder(content_type.second());
+            DynamicTypeBuilder_ptr key = get_member_builder(content_type.first(), context);
+            DynamicTypeBuilder_ptr value = get_member_builder(content_type.second(), context);
             DynamicTypeBuilder_ptr result = factory->create_map_builder(key.get(), value.get(), c_type.bounds());
             return result;
         }
         case ::xtypes::TypeKind::UNION_TYPE:
         {
             const ::xtypes::UnionType& c_type = static_cast<const ::xtypes::UnionType&>(type);
-            DynamicTypeBuilder_ptr disc_type = get_builder(c_type.discriminator());
+            DynamicTypeBuilder_ptr disc_type = get_member_builder(c_type.discriminator(), context);
             DynamicTypeBuilder_ptr result = factory->create_union_builder(disc_type.get());
 
             MemberId idx = 0;
@@ -2572,7 +3055,7 @@ DynamicTypeBuilder_ptr Conversion::get_builder(
                 {
                     labels.push_back(static_cast<uint64_t>(label));
                 }
-                DynamicTypeBuilder_ptr member_builder = get_builder(member.type());
+                DynamicTypeBuilder_ptr member_builder = get_member_builder(member.type(), context);
                 result->add_member(idx++, member_name, member_builder.get(), "", labels, is_default);
             }
             return result;
@@ -2585,7 +3068,7 @@ DynamicTypeBuilder_ptr Conversion::get_builder(
             for (size_t idx = 0; idx < from.members().size(); ++idx)
             {
                 const ::xtypes::Member& member = from.member(idx);
-                DynamicTypeBuilder_ptr member_builder = get_builder(member.type());
+                DynamicTypeBuilder_ptr member_builder = get_member_builder(member.type(), context);
                 DynamicTypeBuilder* builder = static_cast<DynamicTypeBuilder*>(member_builder.get());
                 DynamicTypeBuilder* result_ptr = static_cast<DynamicTypeBuilder*>(result.get());
                 result_ptr->add_member(static_cast<MemberId>(idx), member.name(), builder);
@@ -2598,18 +3081,42 @@ DynamicTypeBuilder_ptr Conversion::get_builder(
     return nullptr;
 }
 
+DynamicTypeBuilder_ptr Conversion::get_member_builder(
+        const ::xtypes::DynamicType& type,
+        ConversionContext* context)
+{
+    switch (resolve_type(type).kind())
+    {
+        case ::xtypes::TypeKind::ENUMERATION_TYPE:
+        case ::xtypes::TypeKind::UNION_TYPE:
+        case ::xtypes::TypeKind::STRUCTURE_TYPE:
+        {
+            if (nullptr != context)
+            {
+                return context->shared_builder(type);
+            }
+            break;
+        }
+        default:
+            // Cheaper to create again than to look up
+            break;
+    }
+    return get_builder(type, context);
+}
+
 void Conversion::get_array_specs(
         const ::xtypes::ArrayType& array,
-        std::pair<std::vector<uint32_t>, DynamicTypeBuilder_ptr>& result)
+        std::pair<std::vector<uint32_t>, DynamicTypeBuilder_ptr>& result,
+        ConversionContext* context)
 {
     result.first.push_back(array.dimension());
     if (array.content_type().kind() == ::xtypes::TypeKind::ARRAY_TYPE)
     {
-        get_array_specs(static_cast<const ::xtypes::ArrayType&>(array.content_type()), result);
+        get_array_specs(static_cast<const ::xtypes::ArrayType&>(array.content_type()), result, context);
     }
     else
     {
-        result.second = get_builder(array.content_type());
+        result.second = get_member_builder(array.content_type(), context);
     }
 }
 
@@ -2674,6 +3181,59 @@ const xtypes::DynamicType& Conversion::resolve_discriminator_type(
     }
 }
 
+DynamicTypeBuilder* ConversionContext::create_builder(
+        const ::xtypes::DynamicType& type)
+{
+    {
+        std::shared_lock<std::shared_mutex> lock(builders_mtx_);
+        auto it = builders_.find(type.name());
+        if (builders_.end() != it)
+        {
+            return static_cast<DynamicTypeBuilder*>(it->second.get());
+        }
+    }
+
+    // Built without the lock, as it is the expensive part. Types with the same structure under
+    // another name only need a shallow copy of it, named after the type.
+    DynamicTypeBuilder_ptr structure = shared_builder(type);
+    if (structure == nullptr)
+    {
+        return nullptr;
+    }
+    DynamicTypeBuilder_ptr builder = DynamicTypeBuilderFactory::get_instance()->create_builder_copy(
+        static_cast<DynamicTypeBuilder*>(structure.get()));
+    builder->set_name(Conversion::convert_type_name(type.name()));
+
+    // If another thread built the same type meanwhile, its builder is kept
+    std::unique_lock<std::shared_mutex> lock(builders_mtx_);
+    auto pair = builders_.emplace(type.name(), std::move(builder));
+    return static_cast<DynamicTypeBuilder*>(pair.first->second.get());
+}
+
+DynamicTypeBuilder_ptr ConversionContext::shared_builder(
+        const ::xtypes::DynamicType& type)
+{
+    const std::string fingerprint = Conversion::fingerprint(type, this);
+    {
+        std::shared_lock<std::shared_mutex> lock(builders_mtx_);
+        auto it = shared_builders_.find(fingerprint);
+        if (shared_builders_.end() != it)
+        {
+            return it->second;
+        }
+    }
+
+    DynamicTypeBuilder_ptr builder = Conversion::get_builder(type, this);
+    if (builder == nullptr)
+    {
+        return nullptr;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(builders_mtx_);
+    auto pair = shared_builders_.emplace(fingerprint, std::move(builder));
+    return pair.first->second;
+}
+
 } //  namespace fastdds
 } //  namespace sh
 } //  namespace is
@@ -24,12 +24,16 @@
 #include <fastrtps/types/DynamicPubSubType.h>
 #include <fastrtps/types/DynamicData.h>
 
+#include "ContentFilter.hpp"
 #include "DDSMiddlewareException.hpp"
 
 #include <is/core/Message.hpp>
 #include <is/utils/Log.hpp>
 
 #include <map>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace fastdds = eprosima::fastdds;
@@ -104,29 +108,64 @@ private:
     static utils::Logger logger_;
 };
 
+/**
+ * Members of a structure selected by a `fields` projection, with the members selected
+ * in turn from each of them. A member without selected members is converted entirely.
+ */
+struct Projection
+{
+    std::map<std::string, std::shared_ptr<Projection> > members;
+};
+
+/** @brief Forward declaration. */
+class ConversionContext;
+
 struct Conversion
 {
+    // A projection restricts the conversion of structures to the selected members.
     static bool xtypes_to_fastdds(
             const ::xtypes::DynamicData& input,
-            DynamicData* output);
+            DynamicData* output,
+            const Projection* projection = nullptr);
 
     static bool fastdds_to_xtypes(
             const DynamicData* input,
-            ::xtypes::DynamicData& output);
-
-    static ::xtypes::DynamicData dynamic_data(
-            const std::string& type_name);
+            ::xtypes::DynamicData& output,
+            const Projection* projection = nullptr);
 
-    static void register_type(
-            const std::string& type_name,
-            DynamicPubSubType* type)
-    {
-        registered_types_.emplace(type_name, type);
-    }
+    // Builds the projection for a list of fields, written as paths with dots through nested structures.
+    static std::shared_ptr<Projection> create_projection(
+            const xtypes::DynamicType& type,
+            const std::vector<std::string>& fields);
 
-    static DynamicTypeBuilder* create_builder(
+    // A type is bounded if all of its strings, sequences and maps, at any depth, are bounded.
+    static bool is_bounded(
             const xtypes::DynamicType& type);
 
+    // Canonical signature of the structure of a type, which ignores type names and resolves aliases.
+    // With a context, the signatures of the type and the types nested in it are computed only once.
+    static std::string fingerprint(
+            const xtypes::DynamicType& type,
+            ConversionContext* context = nullptr);
+
+    // Checks that the path leads, through nested structures, to a primitive, string or enumeration member.
+    static bool is_filterable_member(
+            const xtypes::DynamicType& type,
+            const ContentFilter::Path& path);
+
+    // Gets the enumerators of an enumeration member, through nested structures, for content filtering.
+    // Returns false if the member is not an enumeration.
+    static bool get_enumerators(
+            const xtypes::DynamicType& type,
+            const ContentFilter::Path& path,
+            ContentFilter::Enumerators& enumerators);
+
+    // Reads a primitive, string or enumeration member, through nested structures, for content filtering.
+    static bool fastdds_member_value(
+            const DynamicData* input,
+            const ContentFilter::Path& path,
+            ContentFilter::Value& value);
+
     // This function patches the problem of dynamic types, which do not admit '/' in their type name.
     static std::string convert_type_name(
             const std::string& message_type);
@@ -141,10 +180,9 @@ struct Conversion
 
 private:
 
+    friend class ConversionContext;
+
     ~Conversion() = default;
-    static std::map<std::string, ::xtypes::DynamicType::Ptr> types_;
-    static std::map<std::string, DynamicPubSubType*> registered_types_;
-    static std::map<std::string, DynamicTypeBuilder_ptr> builders_;
 
     static const xtypes::DynamicType& resolve_type(
             const xtypes::DynamicType& type);
@@ -152,12 +190,19 @@ private:
     static TypeKind resolve_type(
             const DynamicType_ptr type);
 
+    // With a context, nested structures, unions and enumerations are shared through it.
     static DynamicTypeBuilder_ptr get_builder(
-            const xtypes::DynamicType& type);
+            const xtypes::DynamicType& type,
+            ConversionContext* context = nullptr);
+
+    static DynamicTypeBuilder_ptr get_member_builder(
+            const xtypes::DynamicType& type,
+            ConversionContext* context);
 
     static void get_array_specs(
             const xtypes::ArrayType& array,
-            std::pair<std::vector<uint32_t>, DynamicTypeBuilder_ptr>& result);
+            std::pair<std::vector<uint32_t>, DynamicTypeBuilder_ptr>& result,
+            ConversionContext* context = nullptr);
 
     // xtypes Dynamic Data -> FastDDS Dynamic Data
     static void set_primitive_data(
@@ -184,7 +229,8 @@ private:
     // xtypes Dynamic Data -> FastDDS Dynamic Data
     static bool set_struct_data(
             ::xtypes::ReadableDynamicDataRef input,
-            DynamicData* output);
+            DynamicData* output,
+            const Projection* projection = nullptr);
 
     // xtypes Dynamic Data -> FastDDS Dynamic Data
     static bool set_union_data(
@@ -210,7 +256,8 @@ private:
     // FastDDS Dynamic Data -> xtypes Dynamic Data
     static bool set_struct_data(
             const DynamicData* input,
-            ::xtypes::WritableDynamicDataRef output);
+            ::xtypes::WritableDynamicDataRef output,
+            const Projection* projection = nullptr);
 
     // FastDDS Dynamic Data -> xtypes Dynamic Data
     static bool set_union_data(
@@ -225,6 +272,70 @@ private:
     static utils::Logger logger_;
 };
 
+/**
+ * @class ConversionContext
+ *        Keeps the *Fast DDS* type builders created for the types of a system, so that each
+ *        SystemHandle has its own, and they are released along with it.
+ */
+class ConversionContext
+{
+public:
+
+    /**
+     * @brief Construct a new empty ConversionContext object.
+     */
+    ConversionContext() = default;
+
+    ConversionContext(
+            const ConversionContext&) = delete;
+
+    ConversionContext& operator =(
+            const ConversionContext&) = delete;
+
+    /**
+     * @brief Get the *Fast DDS* type builder of a type, creating it the first time it is requested.
+     *
+     * @details Safe to call from several threads. The builders of different types are
+     *          created concurrently. Types with the same structure under different names get
+     *          their own named builder, which shares the built members of the structure.
+     *
+     * @param[in] type The *xTypes* type.
+     *
+     * @returns The builder, owned by this context, or `nullptr` if the type cannot be converted.
+     */
+    DynamicTypeBuilder* create_builder(
+            const xtypes::DynamicType& type);
+
+private:
+
+    friend struct Conversion;
+
+    /**
+     * @brief Get the builder of the structure of a type, shared by all the types of this
+     *        context, and the types nested in them, with the same structure, whatever their name.
+     *
+     * @param[in] type The *xTypes* type.
+     *
+     * @returns The shared builder, or `nullptr` if the type cannot be converted.
+     */
+    DynamicTypeBuilder_ptr shared_builder(
+            const xtypes::DynamicType& type);
+
+    /**
+     * Class members.
+     */
+    std::map<std::string, DynamicTypeBuilder_ptr> builders_;
+
+    // Keyed by the fingerprint of the types
+    std::map<std::string, DynamicTypeBuilder_ptr> shared_builders_;
+
+    // Fingerprints of the types of the system, and the types nested in them, which outlive it
+    std::unordered_map<const xtypes::DynamicType*, std::string> fingerprints_;
+
+    // Read far more often than written, once every topic has been created
+    std::shared_mutex builders_mtx_;
+};
+
 } //  namespace fastdds
 } //  namespace sh
 } //  namespace is
@@ -0,0 +1,162 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "OrderedExecutor.hpp"
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace fastdds {
+
+OrderedExecutor::OrderedExecutor(
+        std::size_t threads,
+        ThreadInit thread_init)
+    : thread_init_(std::move(thread_init))
+    , stop_(false)
+{
+    if (0 == threads)
+    {
+        threads = 1;
+    }
+
+    workers_.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i)
+    {
+        workers_.emplace_back(&OrderedExecutor::worker_function, this);
+    }
+}
+
+std::unique_ptr<OrderedExecutor> OrderedExecutor::create(
+        const YAML::Node& dispatch,
+        ThreadInit thread_init)
+{
+    const std::string mode = dispatch["mode"] ? dispatch["mode"].as<std::string>() : "thread_per_sample";
+
+    if ("thread_per_sample" == mode)
+    {
+        return nullptr;
+    }
+    else if ("ordered" != mode)
+    {
+        throw DDSMiddlewareException(
+                  utils::Logger("is::sh::FastDDS::OrderedExecutor"),
+                  "Unknown dispatch mode '" + mode + "'. Allowed values are 'ordered' and 'thread_per_sample'");
+    }
+
+    std::size_t threads = dispatch["threads"]
+            ? dispatch["threads"].as<std::size_t>()
+            : std::thread::hardware_concurrency();
+
+    return std::make_unique<OrderedExecutor>(threads, std::move(thread_init));
+}
+
+OrderedExecutor::~OrderedExecutor()
+{
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+
+    for (std::thread& worker : workers_)
+    {
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+}
+
+void OrderedExecutor::submit(
+        Key key,
+        Task task)
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+
+    auto it = pending_.find(key);
+    if (pending_.end() == it)
+    {
+        // The key is neither waiting nor running: schedule it
+        pending_[key].push_back(std::move(task));
+        ready_.push_back(key);
+        lock.unlock();
+        cv_.notify_one();
+    }
+    else
+    {
+        // The key is already scheduled: the task will run after the previous ones
+        it->second.push_back(std::move(task));
+    }
+}
+
+std::size_t OrderedExecutor::size() const
+{
+    return workers_.size();
+}
+
+void OrderedExecutor::worker_function()
+{
+    if (thread_init_)
+    {
+        thread_init_();
+    }
+
+    std::unique_lock<std::mutex> lock(mtx_);
+
+    while (true)
+    {
+        cv_.wait(
+            lock,
+            [this]()
+            {
+                return stop_ || !ready_.empty();
+            });
+
+        if (ready_.empty())
+        {
+            // Stopping, and every pending task has already been run
+            break;
+        }
+
+        Key key = ready_.front();
+        ready_.pop_front();
+
+        std::deque<Task>& tasks = pending_.at(key);
+        Task task = std::move(tasks.front());
+        tasks.pop_front();
+
+        lock.unlock();
+        task();
+        lock.lock();
+
+        auto it = pending_.find(key);
+        if (it->second.empty())
+        {
+            pending_.erase(it);
+        }
+        else
+        {
+            ready_.push_back(key);
+            cv_.notify_one();
+        }
+    }
+}
+
+} //  namespace fastdds
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
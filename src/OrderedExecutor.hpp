@@ -0,0 +1,148 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _IS_SH_FASTDDS__INTERNAL__ORDEREDEXECUTOR_HPP_
+#define _IS_SH_FASTDDS__INTERNAL__ORDEREDEXECUTOR_HPP_
+
+#include "DDSMiddlewareException.hpp"
+
+#include <yaml-cpp/yaml.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace fastdds {
+
+/**
+ * @class OrderedExecutor
+ *        Pool of worker threads which runs tasks in parallel, while keeping the tasks
+ *        submitted under the same key strictly serialized, in submission order.
+ *
+ * @details Each key owns a FIFO queue of pending tasks. A key is scheduled in the pool
+ *          at most once at a time: when one of its tasks finishes, the next one is
+ *          rescheduled behind the rest of ready keys. Thus, tasks belonging to different
+ *          keys (e.g. different topics or instances) run concurrently, whilst tasks
+ *          belonging to the same key are never reordered nor overlapped.
+ */
+class OrderedExecutor
+{
+public:
+
+    using Key = std::size_t;
+
+    using Task = std::function<void()>;
+
+    using ThreadInit = std::function<void()>;
+
+    /**
+     * @brief Construct a new OrderedExecutor, and launch its worker threads.
+     *
+     * @param[in] threads Number of worker threads. If `0`, one thread is used.
+     *
+     * @param[in] thread_init Optional function run by each worker thread before any task,
+     *            e.g. to set its CPU affinity or scheduling priority.
+     */
+    OrderedExecutor(
+            std::size_t threads,
+            ThreadInit thread_init = nullptr);
+
+    /**
+     * @brief Create the executor selected by the `dispatch` configuration of a system.
+     *
+     * @param[in] dispatch The `dispatch` configuration node. Its `mode` is either
+     *            `thread_per_sample` (default) or `ordered`, whose pool has `threads`
+     *            workers, by default as many as CPU cores.
+     *
+     * @param[in] thread_init Optional function run by each worker thread before any task.
+     *
+     * @returns The executor for the `ordered` mode, or `nullptr` for the `thread_per_sample` mode.
+     *
+     * @throws DDSMiddlewareException If the mode is unknown.
+     */
+    static std::unique_ptr<OrderedExecutor> create(
+            const YAML::Node& dispatch,
+            ThreadInit thread_init = nullptr);
+
+    /**
+     * @brief Destroy the OrderedExecutor. Pending tasks are run before the worker threads finish.
+     */
+    ~OrderedExecutor();
+
+    /**
+     * @brief OrderedExecutor shall not be copy constructible.
+     */
+    OrderedExecutor(
+            const OrderedExecutor& /*rhs*/) = delete;
+
+    /**
+     * @brief OrderedExecutor shall not be copy assignable.
+     */
+    OrderedExecutor& operator = (
+            const OrderedExecutor& /*rhs*/) = delete;
+
+    /**
+     * @brief Enqueue a task.
+     *
+     * @param[in] key The serialization key. Tasks sharing a key run one after the other.
+     *
+     * @param[in] task The task to run.
+     */
+    void submit(
+            Key key,
+            Task task);
+
+    /**
+     * @brief Get the number of worker threads.
+     *
+     * @returns The size of the pool.
+     */
+    std::size_t size() const;
+
+private:
+
+    /**
+     * @brief Worker thread main loop.
+     */
+    void worker_function();
+
+    /**
+     * Class members.
+     */
+    ThreadInit thread_init_;
+    std::unordered_map<Key, std::deque<Task> > pending_;
+    std::deque<Key> ready_;
+    bool stop_;
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::vector<std::thread> workers_;
+};
+
+} //  namespace fastdds
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+#endif //  _IS_SH_FASTDDS__INTERNAL__ORDEREDEXECUTOR_HPP_
@@ -19,45 +19,133 @@
 #include "DDSMiddlewareException.hpp"
 #include "Conversion.hpp"
 
+#include <fastdds/dds/core/status/StatusMask.hpp>
+#include <fastdds/rtps/transport/shared_mem/SharedMemTransportDescriptor.h>
+#include <fastdds/rtps/transport/TCPv4TransportDescriptor.h>
 #include <fastdds/rtps/transport/UDPv4TransportDescriptor.h>
 
 #include <fastrtps/types/DynamicDataFactory.h>
+#include <fastrtps/utils/IPLocator.h>
 #include <fastrtps/xmlparser/XMLProfileManager.h>
 
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <limits>
 #include <sstream>
+#include <thread>
 
 namespace eprosima {
 namespace is {
 namespace sh {
 namespace fastdds {
 
-Participant::Participant()
+#if FASTRTPS_VERSION_MINOR >= 2
+namespace {
+
+/**
+ * @brief DynamicPubSubType for types without unbounded members. Fast DDS only enables
+ *        data-sharing for bounded types, and DynamicPubSubType never reports itself as such.
+ */
+class BoundedDynamicPubSubType : public fastrtps::types::DynamicPubSubType
+{
+public:
+
+    BoundedDynamicPubSubType(
+            const fastrtps::types::DynamicPubSubType& type)
+        : fastrtps::types::DynamicPubSubType(type)
+    {
+    }
+
+    bool is_bounded() const override
+    {
+        return true;
+    }
+
+};
+
+} //  anonymous namespace
+#endif //  if FASTRTPS_VERSION_MINOR >= 2
+
+Participant::Participant(
+        const RealTime* realtime)
     : dds_participant_(nullptr)
+    , realtime_(realtime)
+    , transport_kind_(TransportKind::UDPV4)
+    , shm_segment_size_(0)
+    , shm_port_queue_capacity_(0)
+    , discovery_protocol_(fastrtps::rtps::DiscoveryProtocol_t::SIMPLE)
+    , discovery_ping_period_(0)
+    , static_endpoints_pending_(false)
+    , defer_endpoints_(false)
+    , remote_topics_changed_(false)
     , logger_("is::sh::FastDDS::Participant")
 {
     build_participant();
 }
 
 Participant::Participant(
-        const YAML::Node& config)
+        const YAML::Node& config,
+        const RealTime* realtime)
     : dds_participant_(nullptr)
+    , realtime_(realtime)
+    , transport_kind_(TransportKind::UDPV4)
+    , shm_segment_size_(0)
+    , shm_port_queue_capacity_(0)
+    , discovery_protocol_(fastrtps::rtps::DiscoveryProtocol_t::SIMPLE)
+    , discovery_ping_period_(0)
+    , static_endpoints_pending_(false)
+    , defer_endpoints_(false)
+    , remote_topics_changed_(false)
     , logger_("is::sh::FastDDS::Participant")
 {
     using fastrtps::xmlparser::XMLP_ret;
     using fastrtps::xmlparser::XMLProfileManager;
 
-    if (!config.IsMap() || !config["file_path"] || !config["profile_name"])
+    const bool from_profile = config.IsMap() && config["file_path"] && config["profile_name"];
+
+    for (const char* option : {"transport", "discovery", "static_discovery"})
+    {
+        if (from_profile && config[option])
+        {
+            std::ostringstream err;
+            err << "The '" << option << "' settings of the participant cannot be combined with "
+                << "'file_path' and 'profile_name': configure them in the XML profile instead";
+
+            throw DDSMiddlewareException(logger_, err.str());
+        }
+    }
+
+    if (config.IsMap() && config["transport"])
+    {
+        parse_transport(config["transport"]);
+    }
+
+    if (config.IsMap() && config["discovery"])
+    {
+        parse_discovery(config["discovery"]);
+    }
+
+    if (config.IsMap() && config["static_discovery"])
+    {
+        parse_static_discovery(config["static_discovery"]);
+    }
+
+    if (!from_profile)
     {
-        if (config["domain_id"])
+        if (config["domain_id"] || config["transport"] || config["discovery"] || config["static_discovery"])
         {
-            const ::fastdds::dds::DomainId_t domain_id = config["domain_id"].as<uint32_t>();
+            const ::fastdds::dds::DomainId_t domain_id =
+                    config["domain_id"] ? config["domain_id"].as<uint32_t>() : 0;
             build_participant(domain_id);
         }
         else
         {
             std::ostringstream err;
             err << "The node 'participant' in the YAML configuration of the 'fastdds' system "
-                << "must be a map containing two keys: 'file_path' and 'profile_name'";
+                << "must be a map containing two keys: 'file_path' and 'profile_name', "
+                << "or a 'domain_id', 'transport', 'discovery' or 'static_discovery' key";
 
             throw DDSMiddlewareException(logger_, err.str());
         }
@@ -95,10 +183,21 @@ Participant::Participant(
 
 Participant::~Participant()
 {
-    if (!dds_participant_->has_active_entities())
+    // No discovery callback must reach this object from now on
+    dds_participant_->set_listener(nullptr);
+
+    // Pooled entities go away once every DataWriter and DataReader has been deleted
+    for (const auto& pair : dds_publishers_)
+    {
+        dds_participant_->delete_publisher(pair.second);
+    }
+    for (const auto& pair : dds_subscribers_)
     {
-        dds_participant_->set_listener(nullptr);
+        dds_participant_->delete_subscriber(pair.second);
+    }
 
+    if (!dds_participant_->has_active_entities())
+    {
         if (fastrtps::types::ReturnCode_t::RETCODE_OK !=
                 ::fastdds::dds::DomainParticipantFactory::get_instance()->delete_participant(dds_participant_))
         {
@@ -117,11 +216,13 @@ void Participant::build_participant(
     // By default use UDPv4 due to communication failures between dockers sharing the network with the host
     // When it is solved in Fast-DDS delete the following lines and use the default builtin transport.
     participant_qos.transport().use_builtin_transports = false;
-    auto udp_transport = std::make_shared<::fastdds::rtps::UDPv4TransportDescriptor>();
-    participant_qos.transport().user_transports.push_back(udp_transport);
+    participant_qos.transport().user_transports = create_transports();
+
+    set_discovery_qos(participant_qos);
 
+    // The listener only gets the discovery callbacks, used by the deferred endpoints
     dds_participant_ = ::fastdds::dds::DomainParticipantFactory::get_instance()->create_participant(
-        domain_id, participant_qos);
+        domain_id, participant_qos, this, ::fastdds::dds::StatusMask::none());
 
     if (dds_participant_)
     {
@@ -148,36 +249,54 @@ void Participant::build_participant(
 void Participant::register_dynamic_type(
         const std::string& topic_name,
         const std::string& type_name,
-        fastrtps::types::DynamicTypeBuilder* builder)
+        fastrtps::types::DynamicTypeBuilder* builder,
+        bool bounded)
 {
-    auto topic_to_type_it = topic_to_type_.find(topic_name);
-    if (topic_to_type_it != topic_to_type_.end())
     {
-        return; // Already registered.
-    }
+        std::unique_lock<std::shared_mutex> lock(types_mtx_);
 
-    auto types_it = types_.find(type_name);
-    if (types_.end() != types_it)
-    {
-        // Type known, add the entry in the map topic->type
-        topic_to_type_.emplace(topic_name, type_name);
+        auto topic_to_type_it = topic_to_type_.find(topic_name);
+        if (topic_to_type_it != topic_to_type_.end())
+        {
+            return; // Already registered.
+        }
 
-        logger_ << utils::Logger::Level::DEBUG
-                << "Adding type '" << type_name << "' to topic '"
-                << topic_name << "'" << std::endl;
+        auto types_it = types_.find(type_name);
+        if (types_.end() != types_it)
+        {
+            // Type known, add the entry in the map topic->type
+            topic_to_type_.emplace(topic_name, type_name);
+
+            logger_ << utils::Logger::Level::DEBUG
+                    << "Adding type '" << type_name << "' to topic '"
+                    << topic_name << "'" << std::endl;
 
-        return;
+            return;
+        }
     }
 
+    // Built without the lock, so that the endpoints of different types are created concurrently
     fastrtps::types::DynamicType_ptr dtptr = builder->build();
 
     if (dtptr != nullptr)
     {
+        std::unique_lock<std::shared_mutex> lock(types_mtx_);
+
         auto pair = types_.emplace(type_name, fastrtps::types::DynamicPubSubType(dtptr));
         fastrtps::types::DynamicPubSubType& dynamic_type_support = pair.first->second;
 
         topic_to_type_.emplace(topic_name, type_name);
 
+        if (!pair.second)
+        {
+            // Registered by another thread meanwhile
+            logger_ << utils::Logger::Level::DEBUG
+                    << "Adding type '" << type_name << "' to topic '"
+                    << topic_name << "'" << std::endl;
+
+            return;
+        }
+
         // Check if already registered
         ::fastdds::dds::TypeSupport p_type = dds_participant_->find_type(type_name);
 
@@ -200,7 +319,16 @@ void Participant::register_dynamic_type(
             // WORKAROUND END
 
             // Register it within the DomainParticipant
-            if (pair.second && !dds_participant_->register_type(dynamic_type_support))
+#if FASTRTPS_VERSION_MINOR >= 2
+            ::fastdds::dds::TypeSupport type_support = bounded
+                    ? ::fastdds::dds::TypeSupport(new BoundedDynamicPubSubType(dynamic_type_support))
+                    : ::fastdds::dds::TypeSupport(dynamic_type_support);
+#else
+            (void)bounded;
+            ::fastdds::dds::TypeSupport type_support(dynamic_type_support);
+#endif //  if FASTRTPS_VERSION_MINOR >= 2
+
+            if (!dds_participant_->register_type(type_support))
             {
                 std::ostringstream err;
                 err << "Dynamic type '" << type_name << "' registration failed";
@@ -209,20 +337,9 @@ void Participant::register_dynamic_type(
             }
         }
 
-        if (pair.second)
-        {
-            logger_ << utils::Logger::Level::DEBUG
-                    << "Registered type '" << type_name << "' in topic '"
-                    << topic_name << "'" << std::endl;
-
-            Conversion::register_type(topic_name, &dynamic_type_support);
-        }
-        else
-        {
-            logger_ << utils::Logger::Level::WARN
-                    << "Failed registering type '" << type_name << "' in topic '"
-                    << topic_name << "'" << std::endl;
-        }
+        logger_ << utils::Logger::Level::DEBUG
+                << "Registered type '" << type_name << "' in topic '"
+                << topic_name << "'" << std::endl;
     }
     else
     {
@@ -237,6 +354,8 @@ void Participant::register_dynamic_type(
 fastrtps::types::DynamicData* Participant::create_dynamic_data(
         const std::string& topic_name) const
 {
+    std::shared_lock<std::shared_mutex> lock(types_mtx_);
+
     auto topic_to_type_it = topic_to_type_.find(topic_name);
     if (topic_to_type_.end() == topic_to_type_it)
     {
@@ -269,6 +388,8 @@ void Participant::delete_dynamic_data(
 const fastrtps::types::DynamicType* Participant::get_dynamic_type(
         const std::string& name) const
 {
+    std::shared_lock<std::shared_mutex> lock(types_mtx_);
+
     auto it = types_.find(name);
     if (it == types_.end())
     {
@@ -281,6 +402,8 @@ const fastrtps::types::DynamicType* Participant::get_dynamic_type(
 const std::string& Participant::get_topic_type(
         const std::string& topic) const
 {
+    // The entries are never erased, so the reference outlives the lock
+    std::shared_lock<std::shared_mutex> lock(types_mtx_);
     return topic_to_type_.at(topic);
 }
 
@@ -309,22 +432,334 @@ bool Participant::dissociate_topic_from_dds_entity(
 {
     // std::unique_lock<std::mutex> lock(topic_to_entities_mtx_);
 
-    if (1 == topic_to_entities_.at(topic).size())
+    auto it = topic_to_entities_.find(topic);
+    if (topic_to_entities_.end() == it)
     {
-        // Only one entity remains in the map
-        topic_to_entities_.erase(topic);
+        // The entity failed to be created, and no other entity uses the topic
         return true;
     }
-    else // Size should not be 0 at this point
+
+    it->second.erase(entity);
+    if (it->second.empty())
     {
-        topic_to_entities_.at(topic).erase(entity);
-        return false;
+        topic_to_entities_.erase(it);
+        return true;
+    }
+
+    return false;
+}
+
+::fastdds::dds::PartitionQosPolicy Participant::get_partition_qos(
+        const YAML::Node& partitions) const
+{
+    ::fastdds::dds::PartitionQosPolicy policy;
+    if (!partitions)
+    {
+        return policy;
+    }
+
+    std::vector<std::string> names;
+    if (partitions.IsSequence())
+    {
+        names = partitions.as<std::vector<std::string> >();
+    }
+    else
+    {
+        names.push_back(partitions.as<std::string>());
+    }
+
+    for (const std::string& name : names)
+    {
+        if (name.empty())
+        {
+            throw DDSMiddlewareException(logger_, "Partition names cannot be empty");
+        }
+        policy.push_back(name.c_str());
+    }
+
+    return policy;
+}
+
+/**
+ * @brief Key of the pooled DDS publishers and subscribers, which does not depend on the order
+ *        the partitions were written in.
+ */
+static std::vector<std::string> partitions_key(
+        const ::fastdds::dds::PartitionQosPolicy& partitions)
+{
+    std::vector<std::string> key = partitions.names();
+    std::sort(key.begin(), key.end());
+    key.erase(std::unique(key.begin(), key.end()), key.end());
+    return key;
+}
+
+::fastdds::dds::Publisher* Participant::get_dds_publisher(
+        const ::fastdds::dds::PartitionQosPolicy& partitions)
+{
+    std::vector<std::string> key = partitions_key(partitions);
+
+    std::unique_lock<std::mutex> lock(dds_entities_pool_mtx_);
+    auto it = dds_publishers_.find(key);
+    if (dds_publishers_.end() != it)
+    {
+        return it->second;
+    }
+
+    ::fastdds::dds::PublisherQos publisher_qos = ::fastdds::dds::PUBLISHER_QOS_DEFAULT;
+    publisher_qos.partition() = partitions;
+
+    ::fastdds::dds::Publisher* publisher = dds_participant_->create_publisher(publisher_qos);
+    if (publisher)
+    {
+        logger_ << utils::Logger::Level::DEBUG
+                << "Created Fast DDS publisher for " << key.size() << " partitions" << std::endl;
+
+        dds_publishers_.emplace(std::move(key), publisher);
+    }
+
+    return publisher;
+}
+
+::fastdds::dds::Topic* Participant::get_dds_topic(
+        const std::string& topic_name,
+        const std::string& type_name)
+{
+    std::unique_lock<std::mutex> lock(topic_to_entities_mtx_);
+
+    auto topic_description = dds_participant_->lookup_topicdescription(topic_name);
+    if (topic_description)
+    {
+        return static_cast<::fastdds::dds::Topic*>(topic_description);
+    }
+
+    ::fastdds::dds::Topic* topic = dds_participant_->create_topic(
+        topic_name, type_name, ::fastdds::dds::TOPIC_QOS_DEFAULT);
+    if (topic)
+    {
+        logger_ << utils::Logger::Level::DEBUG
+                << "Created Fast DDS topic '" << topic_name << "' with type '"
+                << type_name << "'" << std::endl;
+    }
+
+    return topic;
+}
+
+::fastdds::dds::Subscriber* Participant::get_dds_subscriber(
+        const ::fastdds::dds::PartitionQosPolicy& partitions)
+{
+    std::vector<std::string> key = partitions_key(partitions);
+
+    std::unique_lock<std::mutex> lock(dds_entities_pool_mtx_);
+    auto it = dds_subscribers_.find(key);
+    if (dds_subscribers_.end() != it)
+    {
+        return it->second;
+    }
+
+    ::fastdds::dds::SubscriberQos subscriber_qos = ::fastdds::dds::SUBSCRIBER_QOS_DEFAULT;
+    subscriber_qos.partition() = partitions;
+
+    ::fastdds::dds::Subscriber* subscriber = dds_participant_->create_subscriber(subscriber_qos);
+    if (subscriber)
+    {
+        logger_ << utils::Logger::Level::DEBUG
+                << "Created Fast DDS subscriber for " << key.size() << " partitions" << std::endl;
+
+        dds_subscribers_.emplace(std::move(key), subscriber);
+    }
+
+    return subscriber;
+}
+
+void Participant::add_lazy_endpoint(
+        const std::string& topic_name,
+        bool writer,
+        const void* owner,
+        std::function<void()> create)
+{
+    std::unique_lock<std::mutex> lock(lazy_endpoints_mtx_);
+    lazy_endpoints_.emplace(topic_name, LazyEndpoint{writer, owner, std::move(create)});
+
+    // The remote endpoints may have been discovered already
+    std::unique_lock<std::mutex> remote_lock(remote_topics_mtx_);
+    remote_topics_changed_ = true;
+}
+
+void Participant::create_endpoint(
+        const void* owner,
+        std::function<void()> create)
+{
+    {
+        std::unique_lock<std::mutex> lock(lazy_endpoints_mtx_);
+        if (defer_endpoints_)
+        {
+            deferred_endpoints_.emplace_back(owner, std::move(create));
+            return;
+        }
+    }
+
+    create();
+}
+
+void Participant::defer_endpoints()
+{
+    std::unique_lock<std::mutex> lock(lazy_endpoints_mtx_);
+    defer_endpoints_ = true;
+}
+
+bool Participant::create_deferred_endpoints(
+        std::size_t threads)
+{
+    // Endpoints are created with the lock held, so that they cannot be cancelled meanwhile
+    std::unique_lock<std::mutex> lock(lazy_endpoints_mtx_);
+    defer_endpoints_ = false;
+
+    if (deferred_endpoints_.empty())
+    {
+        return true;
+    }
+
+    threads = std::max<std::size_t>(1, std::min(threads, deferred_endpoints_.size()));
+
+    logger_ << utils::Logger::Level::INFO
+            << "Creating " << deferred_endpoints_.size() << " deferred endpoints from "
+            << threads << " threads" << std::endl;
+
+    std::atomic<std::size_t> next(0);
+    std::atomic<bool> success(true);
+    auto create = [this, &next, &success]()
+            {
+                for (std::size_t i = next++; i < deferred_endpoints_.size(); i = next++)
+                {
+                    try
+                    {
+                        deferred_endpoints_[i].second();
+                    }
+                    catch (DDSMiddlewareException& e)
+                    {
+                        e.from_logger << utils::Logger::Level::ERROR << e.what() << std::endl;
+                        success = false;
+                    }
+                }
+            };
+
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < threads; ++i)
+    {
+        workers.emplace_back(create);
+    }
+    create();
+
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    deferred_endpoints_.clear();
+
+    return success;
+}
+
+void Participant::cancel_lazy_endpoint(
+        const void* owner)
+{
+    std::unique_lock<std::mutex> lock(lazy_endpoints_mtx_);
+
+    for (auto it = lazy_endpoints_.begin(); it != lazy_endpoints_.end();)
+    {
+        it = owner == it->second.owner ? lazy_endpoints_.erase(it) : std::next(it);
+    }
+
+    deferred_endpoints_.erase(
+        std::remove_if(deferred_endpoints_.begin(), deferred_endpoints_.end(),
+        [owner](const std::pair<const void*, std::function<void()> >& endpoint)
+        {
+            return owner == endpoint.first;
+        }),
+        deferred_endpoints_.end());
+}
+
+bool Participant::create_discovered_endpoints(
+        const std::function<bool(const fastrtps::rtps::GuidPrefix_t&)>& is_local)
+{
+    std::map<std::string, std::set<fastrtps::rtps::GuidPrefix_t> > reader_topics;
+    std::map<std::string, std::set<fastrtps::rtps::GuidPrefix_t> > writer_topics;
+    {
+        std::unique_lock<std::mutex> remote_lock(remote_topics_mtx_);
+        if (!remote_topics_changed_)
+        {
+            return true;
+        }
+        remote_topics_changed_ = false;
+        reader_topics = remote_reader_topics_;
+        writer_topics = remote_writer_topics_;
+    }
+
+    // Endpoints are created with the lock held, so that they cannot be cancelled meanwhile.
+    // The discovery callbacks only take remote_topics_mtx_, so they are never blocked by it.
+    std::unique_lock<std::mutex> lock(lazy_endpoints_mtx_);
+    bool success = true;
+    for (auto it = lazy_endpoints_.begin(); it != lazy_endpoints_.end();)
+    {
+        const auto& remote_topics = it->second.writer ? reader_topics : writer_topics;
+        auto remote_it = remote_topics.find(it->first);
+        if (remote_topics.end() == remote_it
+                || std::all_of(remote_it->second.begin(), remote_it->second.end(), is_local))
+        {
+            ++it;
+            continue;
+        }
+
+        logger_ << utils::Logger::Level::DEBUG
+                << "Creating deferred " << (it->second.writer ? "datawriter" : "datareader")
+                << " for topic '" << it->first << "', as a remote endpoint was discovered" << std::endl;
+
+        try
+        {
+            it->second.create();
+        }
+        catch (DDSMiddlewareException& e)
+        {
+            e.from_logger << utils::Logger::Level::ERROR << e.what() << std::endl;
+            success = false;
+        }
+
+        it = lazy_endpoints_.erase(it);
+    }
+
+    return success;
+}
+
+void Participant::on_subscriber_discovery(
+        ::fastdds::dds::DomainParticipant* /*participant*/,
+        fastrtps::rtps::ReaderDiscoveryInfo&& info)
+{
+    // The endpoints of this system are only told apart when creating the endpoints, as the
+    // sibling participants may be discovered before they are known
+    if (fastrtps::rtps::ReaderDiscoveryInfo::DISCOVERED_READER == info.status)
+    {
+        std::unique_lock<std::mutex> remote_lock(remote_topics_mtx_);
+        remote_topics_changed_ |= remote_reader_topics_[info.info.topicName().to_string()]
+                .insert(info.info.guid().guidPrefix).second;
+    }
+}
+
+void Participant::on_publisher_discovery(
+        ::fastdds::dds::DomainParticipant* /*participant*/,
+        fastrtps::rtps::WriterDiscoveryInfo&& info)
+{
+    if (fastrtps::rtps::WriterDiscoveryInfo::DISCOVERED_WRITER == info.status)
+    {
+        std::unique_lock<std::mutex> remote_lock(remote_topics_mtx_);
+        remote_topics_changed_ |= remote_writer_topics_[info.info.topicName().to_string()]
+                .insert(info.info.guid().guidPrefix).second;
     }
 }
 
 static void set_qos_from_attributes(
         ::fastdds::dds::DomainParticipantQos& qos,
-        const eprosima::fastrtps::rtps::RTPSParticipantAttributes& attr)
+        const eprosima::fastrtps::rtps::RTPSParticipantAttributes& attr,
+        const std::vector<std::shared_ptr<::fastdds::rtps::TransportDescriptorInterface> >& transports)
 {
     qos.user_data().setValue(attr.userData);
     qos.allocation() = attr.allocation;
@@ -342,8 +777,7 @@ static void set_qos_from_attributes(
         // By default use UDPv4 due to communication failures between dockers sharing the network with the host
         // When it is solved in Fast-DDS delete the following lines and use the default builtin transport.
         qos.transport().use_builtin_transports = false;
-        auto udp_transport = std::make_shared<::fastdds::rtps::UDPv4TransportDescriptor>();
-        qos.transport().user_transports.push_back(udp_transport);
+        qos.transport().user_transports = transports;
     }
     else
     {
@@ -365,10 +799,11 @@ static void set_qos_from_attributes(
     if (XMLP_ret::XML_OK == XMLProfileManager::fillParticipantAttributes(profile_name, attr))
     {
         ::fastdds::dds::DomainParticipantQos qos = ::fastdds::dds::PARTICIPANT_QOS_DEFAULT;
-        set_qos_from_attributes(qos, attr.rtps);
+        set_qos_from_attributes(qos, attr.rtps, create_transports());
 
+        // The listener only gets the discovery callbacks, used by the deferred endpoints
         return ::fastdds::dds::DomainParticipantFactory::get_instance()->
-               create_participant(attr.domainId, qos);
+               create_participant(attr.domainId, qos, this, ::fastdds::dds::StatusMask::none());
     }
     else
     {
@@ -380,6 +815,468 @@ static void set_qos_from_attributes(
     }
 }
 
+void Participant::parse_transport(
+        const YAML::Node& config)
+{
+    const std::string kind = config.IsScalar() ? config.as<std::string>()
+            : config["kind"] ? config["kind"].as<std::string>() : "udpv4";
+
+    if ("udpv4" == kind)
+    {
+        transport_kind_ = TransportKind::UDPV4;
+    }
+    else if ("shm" == kind)
+    {
+        transport_kind_ = TransportKind::SHM;
+    }
+    else if ("shm+udpv4" == kind)
+    {
+        transport_kind_ = TransportKind::SHM_UDPV4;
+    }
+    else if ("tcpv4" == kind)
+    {
+        transport_kind_ = TransportKind::TCPV4;
+    }
+    else
+    {
+        throw DDSMiddlewareException(
+                  logger_, "Unknown transport kind '" + kind
+                  + "'. Allowed values are 'udpv4', 'shm', 'shm+udpv4' and 'tcpv4'");
+    }
+
+    if (config.IsMap())
+    {
+        if (config["segment_size"])
+        {
+            shm_segment_size_ = config["segment_size"].as<uint32_t>();
+        }
+
+        if (config["port_queue_capacity"])
+        {
+            shm_port_queue_capacity_ = config["port_queue_capacity"].as<uint32_t>();
+        }
+
+        if (config["listening_ports"])
+        {
+            tcp_listening_ports_ = config["listening_ports"].as<std::vector<uint16_t> >();
+        }
+    }
+
+    logger_ << utils::Logger::Level::DEBUG
+            << "Participant uses transport '" << kind << "'" << std::endl;
+}
+
+std::vector<std::shared_ptr<::fastdds::rtps::TransportDescriptorInterface> > Participant::create_transports() const
+{
+    std::vector<std::shared_ptr<::fastdds::rtps::TransportDescriptorInterface> > transports;
+
+    if (TransportKind::SHM == transport_kind_ || TransportKind::SHM_UDPV4 == transport_kind_)
+    {
+        auto shm_transport = std::make_shared<::fastdds::rtps::SharedMemTransportDescriptor>();
+        if (0 < shm_segment_size_)
+        {
+            shm_transport->segment_size(shm_segment_size_);
+        }
+        if (0 < shm_port_queue_capacity_)
+        {
+            shm_transport->port_queue_capacity(shm_port_queue_capacity_);
+        }
+#if FASTRTPS_VERSION_MINOR >= 12
+        if (nullptr != realtime_)
+        {
+            shm_transport->default_reception_threads(realtime_->thread_settings());
+        }
+#endif //  if FASTRTPS_VERSION_MINOR >= 12
+        transports.push_back(shm_transport);
+    }
+
+    if (TransportKind::UDPV4 == transport_kind_ || TransportKind::SHM_UDPV4 == transport_kind_)
+    {
+        auto udp_transport = std::make_shared<::fastdds::rtps::UDPv4TransportDescriptor>();
+#if FASTRTPS_VERSION_MINOR >= 12
+        if (nullptr != realtime_)
+        {
+            udp_transport->default_reception_threads(realtime_->thread_settings());
+        }
+#endif //  if FASTRTPS_VERSION_MINOR >= 12
+        transports.push_back(udp_transport);
+    }
+
+    if (TransportKind::TCPV4 == transport_kind_)
+    {
+        auto tcp_transport = std::make_shared<::fastdds::rtps::TCPv4TransportDescriptor>();
+        for (uint16_t port : tcp_listening_ports_)
+        {
+            tcp_transport->add_listener_port(port);
+        }
+#if FASTRTPS_VERSION_MINOR >= 12
+        if (nullptr != realtime_)
+        {
+            tcp_transport->default_reception_threads(realtime_->thread_settings());
+        }
+#endif //  if FASTRTPS_VERSION_MINOR >= 12
+        transports.push_back(tcp_transport);
+    }
+
+    return transports;
+}
+
+/**
+ * @brief Parse a GUID prefix written as twelve dot-separated hexadecimal bytes,
+ *        e.g. `44.53.00.5f.45.50.52.4f.53.49.4d.41`.
+ */
+static bool parse_guid_prefix(
+        const std::string& text,
+        fastrtps::rtps::GuidPrefix_t& prefix)
+{
+    std::istringstream stream(text);
+    std::string byte;
+    size_t i = 0;
+
+    while (std::getline(stream, byte, '.'))
+    {
+        if (fastrtps::rtps::GuidPrefix_t::size <= i || byte.empty() || 2 < byte.size()
+                || std::string::npos != byte.find_first_not_of("0123456789abcdefABCDEF"))
+        {
+            return false;
+        }
+        prefix.value[i++] = static_cast<fastrtps::rtps::octet>(std::stoul(byte, nullptr, 16));
+    }
+
+    return fastrtps::rtps::GuidPrefix_t::size == i;
+}
+
+void Participant::parse_discovery(
+        const YAML::Node& config)
+{
+    const std::string mode = config["mode"] ? config["mode"].as<std::string>() : "simple";
+
+    if ("simple" == mode)
+    {
+        discovery_protocol_ = fastrtps::rtps::DiscoveryProtocol_t::SIMPLE;
+    }
+    else if ("client" == mode)
+    {
+        discovery_protocol_ = fastrtps::rtps::DiscoveryProtocol_t::CLIENT;
+    }
+#if FASTRTPS_VERSION_MINOR >= 2
+    else if ("super_client" == mode)
+    {
+        discovery_protocol_ = fastrtps::rtps::DiscoveryProtocol_t::SUPER_CLIENT;
+    }
+#endif //  if FASTRTPS_VERSION_MINOR >= 2
+    else
+    {
+        throw DDSMiddlewareException(
+                  logger_, "Unknown discovery mode '" + mode
+                  + "'. Allowed values are 'simple', 'client' and 'super_client' (Fast DDS v2.2.0 or newer)");
+    }
+
+    if (fastrtps::rtps::DiscoveryProtocol_t::SIMPLE != discovery_protocol_)
+    {
+        if (!config["servers"] || !config["servers"].IsSequence() || 0 == config["servers"].size())
+        {
+            throw DDSMiddlewareException(
+                      logger_, "The discovery mode '" + mode + "' requires a list of 'servers'");
+        }
+
+        if (TransportKind::SHM == transport_kind_)
+        {
+            throw DDSMiddlewareException(
+                      logger_, "Discovery servers cannot be reached through the 'shm' transport alone");
+        }
+
+        for (const YAML::Node& server_config : config["servers"])
+        {
+            if (!server_config["address"] || !server_config["port"])
+            {
+                throw DDSMiddlewareException(
+                          logger_, "Each discovery server requires an 'address' and a 'port'");
+            }
+
+            DiscoveryServer server;
+            server.address = server_config["address"].as<std::string>();
+            server.port = server_config["port"].as<uint16_t>();
+
+            // By default, the prefix of the server launched with `fastdds discovery -i <index>`
+            std::ostringstream default_prefix;
+            default_prefix << "44.53." << std::hex << std::setw(2) << std::setfill('0')
+                           << discovery_servers_.size() << ".5f.45.50.52.4f.53.49.4d.41";
+
+            const std::string prefix = server_config["guid_prefix"]
+                    ? server_config["guid_prefix"].as<std::string>()
+                    : default_prefix.str();
+
+            if (!parse_guid_prefix(prefix, server.guid_prefix))
+            {
+                throw DDSMiddlewareException(
+                          logger_, "Invalid discovery server GUID prefix '" + prefix + "'");
+            }
+
+            discovery_servers_.push_back(server);
+        }
+
+        if (config["ping_period"])
+        {
+            discovery_ping_period_ = config["ping_period"].as<double>();
+            if (0 >= discovery_ping_period_)
+            {
+                throw DDSMiddlewareException(
+                          logger_, "The discovery 'ping_period' must be greater than 0");
+            }
+        }
+    }
+
+    if (config["guid_prefix"])
+    {
+        const std::string prefix = config["guid_prefix"].as<std::string>();
+        if (!parse_guid_prefix(prefix, guid_prefix_))
+        {
+            throw DDSMiddlewareException(logger_, "Invalid participant GUID prefix '" + prefix + "'");
+        }
+    }
+
+    logger_ << utils::Logger::Level::DEBUG
+            << "Participant uses discovery mode '" << mode << "' with "
+            << discovery_servers_.size() << " servers" << std::endl;
+}
+
+void Participant::set_discovery_qos(
+        ::fastdds::dds::DomainParticipantQos& qos) const
+{
+    using fastrtps::rtps::IPLocator;
+
+    if (guid_prefix_ != fastrtps::rtps::GuidPrefix_t::unknown())
+    {
+        qos.wire_protocol().prefix = guid_prefix_;
+    }
+
+    fastrtps::rtps::DiscoverySettings& discovery = qos.wire_protocol().builtin.discovery_config;
+    discovery.discoveryProtocol = discovery_protocol_;
+
+    for (const DiscoveryServer& server : discovery_servers_)
+    {
+        fastrtps::rtps::Locator_t locator;
+        if (TransportKind::TCPV4 == transport_kind_)
+        {
+            locator.kind = LOCATOR_KIND_TCPv4;
+            IPLocator::setIPv4(locator, server.address);
+            IPLocator::setPhysicalPort(locator, server.port);
+            IPLocator::setLogicalPort(locator, server.port);
+        }
+        else
+        {
+            locator.kind = LOCATOR_KIND_UDPv4;
+            IPLocator::setIPv4(locator, server.address);
+            locator.port = server.port;
+        }
+
+        fastrtps::rtps::RemoteServerAttributes remote_server;
+        remote_server.guidPrefix = server.guid_prefix;
+        remote_server.metatrafficUnicastLocatorList.push_back(locator);
+        discovery.m_DiscoveryServers.push_back(remote_server);
+    }
+
+    if (0 < discovery_ping_period_)
+    {
+        discovery.discoveryServer_client_syncperiod = fastrtps::Duration_t(discovery_ping_period_);
+    }
+
+    if (!static_peers_file_.empty())
+    {
+        discovery.use_SIMPLE_EndpointDiscoveryProtocol = false;
+        discovery.use_STATIC_EndpointDiscoveryProtocol = true;
+        discovery.static_edp_xml_config(("file://" + static_peers_file_).c_str());
+    }
+}
+
+void Participant::parse_static_discovery(
+        const YAML::Node& config)
+{
+    if (!config["peers"])
+    {
+        throw DDSMiddlewareException(
+                  logger_, "Static discovery requires the 'peers' XML file describing the remote endpoints");
+    }
+
+    static_peers_file_ = config["peers"].as<std::string>();
+    if (config["output"])
+    {
+        static_output_file_ = config["output"].as<std::string>();
+    }
+
+    logger_ << utils::Logger::Level::DEBUG
+            << "Participant uses static endpoint discovery with peers '" << static_peers_file_
+            << "'" << std::endl;
+}
+
+int16_t Participant::add_static_writer(
+        const ::fastdds::dds::Topic* topic,
+        const ::fastdds::dds::Publisher* publisher,
+        const ::fastdds::dds::DataWriterQos& qos)
+{
+    StaticEndpoint endpoint;
+    endpoint.writer = true;
+    endpoint.reliable = ::fastdds::dds::RELIABLE_RELIABILITY_QOS == qos.reliability().kind;
+    endpoint.durability = qos.durability().kind;
+    endpoint.partitions = publisher->get_qos().partition().names();
+
+    return add_static_endpoint(std::move(endpoint), topic);
+}
+
+int16_t Participant::add_static_reader(
+        const ::fastdds::dds::Topic* topic,
+        const ::fastdds::dds::Subscriber* subscriber,
+        const ::fastdds::dds::DataReaderQos& qos)
+{
+    StaticEndpoint endpoint;
+    endpoint.writer = false;
+    endpoint.reliable = ::fastdds::dds::RELIABLE_RELIABILITY_QOS == qos.reliability().kind;
+    endpoint.durability = qos.durability().kind;
+    endpoint.partitions = subscriber->get_qos().partition().names();
+
+    return add_static_endpoint(std::move(endpoint), topic);
+}
+
+int16_t Participant::add_static_endpoint(
+        StaticEndpoint endpoint,
+        const ::fastdds::dds::Topic* topic)
+{
+    if (static_peers_file_.empty())
+    {
+        return -1;
+    }
+
+    endpoint.topic_name = topic->get_name();
+    endpoint.type_name = topic->get_type_name();
+
+    {
+        // Endpoints may be created from several startup threads at once
+        std::shared_lock<std::shared_mutex> types_lock(types_mtx_);
+        auto types_it = types_.find(endpoint.type_name);
+        endpoint.keyed = types_.end() != types_it && types_it->second.m_isGetKeyDefined;
+    }
+
+    std::unique_lock<std::mutex> lock(static_endpoints_mtx_);
+    if (static_cast<size_t>(std::numeric_limits<int16_t>::max()) <= static_endpoints_.size())
+    {
+        throw DDSMiddlewareException(logger_, "Too many endpoints for static discovery");
+    }
+
+    // User defined IDs must be positive and unique within the participant
+    endpoint.user_id = static_cast<int16_t>(static_endpoints_.size() + 1);
+    static_endpoints_.push_back(std::move(endpoint));
+    static_endpoints_pending_ = !static_output_file_.empty();
+
+    return static_endpoints_.back().user_id;
+}
+
+/**
+ * @brief Escape the characters with a special meaning in XML.
+ */
+static std::string xml_escape(
+        const std::string& text)
+{
+    std::string escaped;
+    for (char c : text)
+    {
+        switch (c)
+        {
+            case '&':
+                escaped += "&amp;";
+                break;
+            case '<':
+                escaped += "&lt;";
+                break;
+            case '>':
+                escaped += "&gt;";
+                break;
+            case '"':
+                escaped += "&quot;";
+                break;
+            case '\'':
+                escaped += "&apos;";
+                break;
+            default:
+                escaped += c;
+        }
+    }
+    return escaped;
+}
+
+bool Participant::write_static_endpoints()
+{
+    std::unique_lock<std::mutex> lock(static_endpoints_mtx_);
+    if (!static_endpoints_pending_)
+    {
+        return true;
+    }
+
+    std::ofstream file(static_output_file_);
+    file << "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n"
+         << "<staticdiscovery>\n"
+         << "    <participant>\n"
+         << "        <name>" << xml_escape(dds_participant_->get_qos().name().to_string()) << "</name>\n";
+
+    for (const StaticEndpoint& endpoint : static_endpoints_)
+    {
+        const char* kind = endpoint.writer ? "writer" : "reader";
+
+        file << "        <" << kind << ">\n"
+             << "            <userId>" << endpoint.user_id << "</userId>\n"
+             << "            <topicName>" << xml_escape(endpoint.topic_name) << "</topicName>\n"
+             << "            <topicDataType>" << xml_escape(endpoint.type_name) << "</topicDataType>\n"
+             << "            <topicKind>" << (endpoint.keyed ? "WITH_KEY" : "NO_KEY") << "</topicKind>\n"
+             << "            <reliabilityQos>"
+             << (endpoint.reliable ? "RELIABLE_RELIABILITY_QOS" : "BEST_EFFORT_RELIABILITY_QOS")
+             << "</reliabilityQos>\n"
+             << "            <durabilityQos>";
+
+        switch (endpoint.durability)
+        {
+            case ::fastdds::dds::TRANSIENT_LOCAL_DURABILITY_QOS:
+                file << "TRANSIENT_LOCAL_DURABILITY_QOS";
+                break;
+            case ::fastdds::dds::TRANSIENT_DURABILITY_QOS:
+                file << "TRANSIENT_DURABILITY_QOS";
+                break;
+            case ::fastdds::dds::PERSISTENT_DURABILITY_QOS:
+                file << "PERSISTENT_DURABILITY_QOS";
+                break;
+            default:
+                file << "VOLATILE_DURABILITY_QOS";
+        }
+
+        file << "</durabilityQos>\n";
+
+        for (const std::string& partition : endpoint.partitions)
+        {
+            file << "            <partitionQos>" << xml_escape(partition) << "</partitionQos>\n";
+        }
+
+        file << "        </" << kind << ">\n";
+    }
+
+    file << "    </participant>\n"
+         << "</staticdiscovery>\n";
+    file.close();
+
+    if (!file)
+    {
+        logger_ << utils::Logger::Level::ERROR
+                << "Cannot write the static discovery file '" << static_output_file_ << "'" << std::endl;
+        return false;
+    }
+
+    static_endpoints_pending_ = false;
+
+    logger_ << utils::Logger::Level::INFO
+            << "Written " << static_endpoints_.size() << " endpoints to the static discovery file '"
+            << static_output_file_ << "'" << std::endl;
+
+    return true;
+}
+
 } //  namespace fastdds
 } //  namespace sh
 } //  namespace is
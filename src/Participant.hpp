@@ -18,18 +18,36 @@
 #define _IS_SH_FASTDDS__INTERNAL__PARTICIPANT_HPP_
 
 #include "DDSMiddlewareException.hpp"
+#include "RealTime.hpp"
 
 #include <fastdds/dds/core/Entity.hpp>
+#include <fastdds/dds/core/policy/QosPolicies.hpp>
 #include <fastdds/dds/domain/DomainParticipant.hpp>
 #include <fastdds/dds/domain/DomainParticipantFactory.hpp>
 #include <fastdds/dds/domain/DomainParticipantListener.hpp>
+#include <fastdds/dds/domain/qos/DomainParticipantQos.hpp>
+#include <fastdds/dds/publisher/Publisher.hpp>
+#include <fastdds/dds/publisher/qos/DataWriterQos.hpp>
+#include <fastdds/dds/subscriber/Subscriber.hpp>
+#include <fastdds/dds/subscriber/qos/DataReaderQos.hpp>
+#include <fastdds/rtps/attributes/RTPSParticipantAttributes.h>
+#include <fastdds/rtps/common/GuidPrefix_t.hpp>
+#include <fastdds/rtps/transport/TransportDescriptorInterface.h>
 #include <fastrtps/types/DynamicType.h>
 
 #include <is/utils/Log.hpp>
 
 #include <yaml-cpp/yaml.h>
 
+#include <cstdint>
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <vector>
 
 namespace fastdds = eprosima::fastdds;
 
@@ -52,16 +70,20 @@ namespace fastdds {
  *          Fast DDS DomainParticipantListener</a> class to scan for state changes on the DDS
  *          participant created by this *Integration Service* is::SystemHandle.
  */
-class Participant
+class Participant : public ::fastdds::dds::DomainParticipantListener
 {
 public:
 
     /**
      * @brief Construct a new Participant, with default values.
      *
+     * @param[in] realtime Optional real-time settings, applied to the *Fast DDS* reception threads
+     *            when the *Fast DDS* version allows it.
+     *
      * @throws DDSMiddlewareException If the *DomainParticipant* could not be created.
      */
-    Participant();
+    Participant(
+            const RealTime* realtime = nullptr);
 
     /**
      * @brief Construct a new Participant object with the user-provided parameters
@@ -79,11 +101,47 @@ public:
      *              that corresponds to the configuration profile that we want this Participant
      *              to be configured with.
      *
-     * @throws DDSMiddlewareException If the XML profile was incorrect and, thus, the
+     *            Alternatively, the participant can be built with default values and a `domain_id`.
+     *            In that case, and only in that case, as XML profiles configure them on their own,
+     *            an optional `transport` map selects the *Fast DDS* transports used instead of
+     *            the builtin ones:
+     *
+     *            - `kind`: One of `udpv4` (default), `shm`, `shm+udpv4` or `tcpv4`.
+     *
+     *            - `segment_size`, `port_queue_capacity`: Shared memory segment size in bytes
+     *              and port queue capacity in messages, for the `shm` kinds.
+     *
+     *            - `listening_ports`: List of ports accepting incoming connections, for `tcpv4`.
+     *
+     *            An optional `discovery` map makes the participant a *Discovery Server* client:
+     *
+     *            - `mode`: Either `simple` (default), `client` or `super_client`.
+     *
+     *            - `servers`: List of servers, each of them a map with their IPv4 `address`,
+     *              `port` and, optionally, `guid_prefix`.
+     *
+     *            - `ping_period`: Period, in seconds, of the client pings to the servers.
+     *
+     *            - `guid_prefix`: GUID prefix of the participant itself.
+     *
+     *            An optional `static_discovery` map replaces the simple endpoint discovery
+     *            by the *Fast DDS* static one:
+     *
+     *            - `peers`: Path to the XML file describing the endpoints of the remote participants.
+     *
+     *            - `output`: Path where the XML file describing the endpoints of this participant
+     *              is written, to be loaded by the remote participants.
+     *
+     * @param[in] realtime Optional real-time settings, applied to the *Fast DDS* reception threads
+     *            when the *Fast DDS* version allows it.
+     *
+     * @throws DDSMiddlewareException If the XML profile, the transport or the discovery settings were incorrect,
+     *         or an XML profile was combined with transport or discovery settings; and, thus, the
      *         *DomainParticipant* could not be created.
      */
     Participant(
-            const YAML::Node& config);
+            const YAML::Node& config,
+            const RealTime* realtime = nullptr);
 
     /**
      * @brief Destroy the Participant object.
@@ -117,12 +175,17 @@ public:
      *
      * @param[in] builder A class that represents a builder for the desired *Dynamic Type*.
      *
+     * @param[in] bounded Whether the type has a bounded serialized size, so that it can be
+     *            delivered using *Fast DDS* data-sharing. Only taken into account by the
+     *            first registration of the type.
+     *
      * @throws DDSMiddlewareException If the type could not be registered.
      */
     void register_dynamic_type(
             const std::string& topic_name,
             const std::string& type_name,
-            fastrtps::types::DynamicTypeBuilder* builder);
+            fastrtps::types::DynamicTypeBuilder* builder,
+            bool bounded = false);
 
     /**
      * @brief Create an empty dynamic data object for the specified topic.
@@ -187,12 +250,192 @@ public:
      * @param[in] topic The name of the topic to unregister.
      *
      * @param[in] entity A pointer to the entity to be unregistered.
+     *
+     * @returns `true` if no entity uses the topic anymore, so that it can be deleted.
      */
 
     bool dissociate_topic_from_dds_entity(
             ::fastdds::dds::Topic* topic,
             ::fastdds::dds::DomainEntity* entity);
 
+    /**
+     * @brief Build the *DDS Partition* QoS policy from the `partitions` option of a topic,
+     *        which is either a single partition name or a list of them.
+     *
+     * @details Partition names may contain the `*`, `?` and `[]` wildcards, which *Fast DDS*
+     *          matches against the partitions of the remote endpoints.
+     *
+     * @param[in] partitions The `partitions` configuration node. If it is not defined,
+     *            the default (empty) partition is used.
+     *
+     * @returns The partition policy.
+     *
+     * @throws DDSMiddlewareException If some partition name is empty.
+     */
+    ::fastdds::dds::PartitionQosPolicy get_partition_qos(
+            const YAML::Node& partitions) const;
+
+    /**
+     * @brief Get the *DDS Publisher* shared by every DataWriter of this participant
+     *        in the given partitions, creating it the first time it is requested.
+     *
+     * @details Pooled publishers are kept until the participant is destroyed, so that
+     *          topics only create and delete their own DataWriters.
+     *
+     * @param[in] partitions The partitions of the publisher.
+     *
+     * @returns The DDS publisher, or `nullptr` if it could not be created.
+     */
+    ::fastdds::dds::Publisher* get_dds_publisher(
+            const ::fastdds::dds::PartitionQosPolicy& partitions);
+
+    /**
+     * @brief Get the *DDS Topic* with the given name, creating it the first time it is requested.
+     *
+     * @details Lookup and creation are atomic, so that the endpoints of the same topic
+     *          can be created from several threads.
+     *
+     * @param[in] topic_name The topic name.
+     *
+     * @param[in] type_name The name of the registered type of the topic.
+     *
+     * @returns The DDS topic, or `nullptr` if it could not be created.
+     */
+    ::fastdds::dds::Topic* get_dds_topic(
+            const std::string& topic_name,
+            const std::string& type_name);
+
+    /**
+     * @brief Get the *DDS Subscriber* shared by every DataReader of this participant
+     *        in the given partitions, creating it the first time it is requested.
+     *
+     * @details Pooled subscribers are kept until the participant is destroyed, so that
+     *          topics only create and delete their own DataReaders.
+     *
+     * @param[in] partitions The partitions of the subscriber.
+     *
+     * @returns The DDS subscriber, or `nullptr` if it could not be created.
+     */
+    ::fastdds::dds::Subscriber* get_dds_subscriber(
+            const ::fastdds::dds::PartitionQosPolicy& partitions);
+
+    /**
+     * @brief Add a DataWriter to the endpoints announced through static discovery.
+     *
+     * @param[in] topic The topic of the DataWriter.
+     *
+     * @param[in] publisher The DDS publisher the DataWriter will belong to.
+     *
+     * @param[in] qos The QoS of the DataWriter.
+     *
+     * @returns The user defined ID to be set in the QoS of the DataWriter, or `-1`
+     *          if static discovery is not enabled.
+     */
+    int16_t add_static_writer(
+            const ::fastdds::dds::Topic* topic,
+            const ::fastdds::dds::Publisher* publisher,
+            const ::fastdds::dds::DataWriterQos& qos);
+
+    /**
+     * @brief Add a DataReader to the endpoints announced through static discovery.
+     *
+     * @param[in] topic The topic of the DataReader.
+     *
+     * @param[in] subscriber The DDS subscriber the DataReader will belong to.
+     *
+     * @param[in] qos The QoS of the DataReader.
+     *
+     * @returns The user defined ID to be set in the QoS of the DataReader, or `-1`
+     *          if static discovery is not enabled.
+     */
+    int16_t add_static_reader(
+            const ::fastdds::dds::Topic* topic,
+            const ::fastdds::dds::Subscriber* subscriber,
+            const ::fastdds::dds::DataReaderQos& qos);
+
+    /**
+     * @brief Write the static discovery `output` file, if endpoints were added since
+     *        it was last written.
+     *
+     * @returns `false` if the file could not be written.
+     */
+    bool write_static_endpoints();
+
+    /**
+     * @brief Defer the creation of a DataWriter or DataReader until a remote endpoint
+     *        of the same topic is discovered.
+     *
+     * @details Remote DataReaders trigger the creation of the deferred DataWriters, and remote
+     *          DataWriters the creation of the deferred DataReaders. Creation does not happen
+     *          in the *Fast DDS* discovery thread, but on the next call to create_discovered_endpoints().
+     *
+     * @param[in] topic_name The topic of the endpoint.
+     *
+     * @param[in] writer Whether the endpoint is a DataWriter or a DataReader.
+     *
+     * @param[in] owner Identifies the endpoint, so that it can be cancelled.
+     *
+     * @param[in] create Creates the endpoint. It may throw DDSMiddlewareException.
+     */
+    void add_lazy_endpoint(
+            const std::string& topic_name,
+            bool writer,
+            const void* owner,
+            std::function<void()> create);
+
+    /**
+     * @brief Create a DataWriter or DataReader right away or, once defer_endpoints() has
+     *        been called, on the next call to create_deferred_endpoints().
+     *
+     * @param[in] owner Identifies the endpoint, so that it can be cancelled.
+     *
+     * @param[in] create Creates the endpoint. It may throw DDSMiddlewareException, which is
+     *            only propagated if the endpoint is created right away; otherwise, it is
+     *            reported by create_deferred_endpoints().
+     */
+    void create_endpoint(
+            const void* owner,
+            std::function<void()> create);
+
+    /**
+     * @brief Defer the endpoints given to create_endpoint() until create_deferred_endpoints()
+     *        is called, so that the endpoints of a large configuration are created in parallel.
+     */
+    void defer_endpoints();
+
+    /**
+     * @brief Create the endpoints deferred by defer_endpoints(), distributing them across
+     *        several threads, and create the following ones right away.
+     *
+     * @param[in] threads The maximum number of threads creating endpoints.
+     *
+     * @returns `false` if some of the endpoints could not be created.
+     */
+    bool create_deferred_endpoints(
+            std::size_t threads);
+
+    /**
+     * @brief Cancel the deferred creation of an endpoint, waiting for it to finish if
+     *        it is being created.
+     *
+     * @param[in] owner The owner given to add_lazy_endpoint() or create_endpoint().
+     */
+    void cancel_lazy_endpoint(
+            const void* owner);
+
+    /**
+     * @brief Create the deferred endpoints whose topic has been discovered on a remote
+     *        endpoint of the opposite kind.
+     *
+     * @param[in] is_local Tells whether a participant belongs to the *Integration Service*,
+     *            so that its endpoints, e.g. those of the sibling participants of the same
+     *            system, do not trigger the creation.
+     *
+     * @returns `false` if some of the endpoints could not be created.
+     */
+    bool create_discovered_endpoints(
+            const std::function<bool(const fastrtps::rtps::GuidPrefix_t&)>& is_local);
+
 private:
 
     /**
@@ -210,17 +453,166 @@ private:
     ::fastdds::dds::DomainParticipant* create_participant_with_profile(
         const std::string& profile_name);
 
+    /**
+     * @brief Parse the `transport` section of the participant configuration.
+     *
+     * @param[in] config The `transport` configuration node.
+     *
+     * @throws DDSMiddlewareException If some field has an invalid value.
+     */
+    void parse_transport(
+            const YAML::Node& config);
+
+    /**
+     * @brief Create the transport descriptors selected by the `transport` configuration,
+     *        which replace the *Fast DDS* builtin transports.
+     *
+     * @returns The list of user transports for the *DomainParticipant*.
+     */
+    std::vector<std::shared_ptr<::fastdds::rtps::TransportDescriptorInterface> > create_transports() const;
+
+    /**
+     * @brief Parse the `discovery` section of the participant configuration.
+     *
+     * @param[in] config The `discovery` configuration node.
+     *
+     * @throws DDSMiddlewareException If some field has an invalid value.
+     */
+    void parse_discovery(
+            const YAML::Node& config);
+
+    /**
+     * @brief Set the discovery protocol selected by the `discovery` configuration, along with
+     *        the *Discovery Server* locators, in the QoS of the *DomainParticipant*.
+     *
+     * @param[in,out] qos The QoS of the *DomainParticipant* to be created.
+     */
+    void set_discovery_qos(
+            ::fastdds::dds::DomainParticipantQos& qos) const;
+
+    /**
+     * @brief Parse the `static_discovery` section of the participant configuration.
+     *
+     * @param[in] config The `static_discovery` configuration node.
+     *
+     * @throws DDSMiddlewareException If some field is missing.
+     */
+    void parse_static_discovery(
+            const YAML::Node& config);
+
+    /**
+     * @brief Inherited from *DomainParticipantListener*. Records the topics of the remote DataReaders.
+     */
+    void on_subscriber_discovery(
+            ::fastdds::dds::DomainParticipant* /*participant*/,
+            fastrtps::rtps::ReaderDiscoveryInfo&& info) override;
+
+    /**
+     * @brief Inherited from *DomainParticipantListener*. Records the topics of the remote DataWriters.
+     */
+    void on_publisher_discovery(
+            ::fastdds::dds::DomainParticipant* /*participant*/,
+            fastrtps::rtps::WriterDiscoveryInfo&& info) override;
+
+    /**
+     * @brief Transport kinds allowed in the `transport` configuration.
+     */
+    enum class TransportKind
+    {
+        UDPV4,
+        SHM,
+        SHM_UDPV4,
+        TCPV4
+    };
+
+    /**
+     * @brief *Discovery Server* the participant connects to, as a client.
+     */
+    struct DiscoveryServer
+    {
+        std::string address;
+        uint16_t port;
+        fastrtps::rtps::GuidPrefix_t guid_prefix;
+    };
+
+    /**
+     * @brief Endpoint of this participant, announced through static discovery.
+     */
+    struct StaticEndpoint
+    {
+        bool writer;
+        int16_t user_id;
+        std::string topic_name;
+        std::string type_name;
+        bool keyed;
+        bool reliable;
+        ::fastdds::dds::DurabilityQosPolicyKind durability;
+        std::vector<std::string> partitions;
+    };
+
+    /**
+     * @brief DataWriter or DataReader whose creation is deferred.
+     */
+    struct LazyEndpoint
+    {
+        bool writer;
+        const void* owner;
+        std::function<void()> create;
+    };
+
+    /**
+     * @brief Add an endpoint to the ones announced through static discovery.
+     *
+     * @returns The user defined ID of the endpoint, or `-1` if static discovery is not enabled.
+     */
+    int16_t add_static_endpoint(
+            StaticEndpoint endpoint,
+            const ::fastdds::dds::Topic* topic);
+
 
     /**
      * Class members.
      */
     ::fastdds::dds::DomainParticipant* dds_participant_;
+    const RealTime* realtime_;
+
+    TransportKind transport_kind_;
+    uint32_t shm_segment_size_;
+    uint32_t shm_port_queue_capacity_;
+    std::vector<uint16_t> tcp_listening_ports_;
+
+    fastrtps::rtps::DiscoveryProtocol_t discovery_protocol_;
+    std::vector<DiscoveryServer> discovery_servers_;
+    double discovery_ping_period_;
+    fastrtps::rtps::GuidPrefix_t guid_prefix_;
+
+    std::string static_peers_file_;
+    std::string static_output_file_;
+    std::vector<StaticEndpoint> static_endpoints_;
+    bool static_endpoints_pending_;
+    std::mutex static_endpoints_mtx_;
+
+    // Deferred endpoints per topic, and topics of the remote endpoints discovered so far,
+    // along with the participants of those endpoints
+    std::multimap<std::string, LazyEndpoint> lazy_endpoints_;
+    std::vector<std::pair<const void*, std::function<void()> > > deferred_endpoints_;
+    bool defer_endpoints_;
+    std::mutex lazy_endpoints_mtx_;
+    std::map<std::string, std::set<fastrtps::rtps::GuidPrefix_t> > remote_reader_topics_;
+    std::map<std::string, std::set<fastrtps::rtps::GuidPrefix_t> > remote_writer_topics_;
+    bool remote_topics_changed_;
+    std::mutex remote_topics_mtx_;
 
     std::map<std::string, fastrtps::types::DynamicPubSubType> types_;
     std::map<std::string, std::string> topic_to_type_;
+    mutable std::shared_mutex types_mtx_;
     std::map<::fastdds::dds::Topic*, std::set<::fastdds::dds::DomainEntity*> > topic_to_entities_;
     std::mutex topic_to_entities_mtx_;
 
+    std::map<std::vector<std::string>, ::fastdds::dds::Publisher*> dds_publishers_;
+    std::map<std::vector<std::string>, ::fastdds::dds::Subscriber*> dds_subscribers_;
+    std::mutex dds_entities_pool_mtx_;
+
     is::utils::Logger logger_;
 };
 
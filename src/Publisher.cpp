@@ -22,6 +22,7 @@
 #include <fastdds/dds/topic/Topic.hpp>
 #include <fastdds/dds/publisher/DataWriter.hpp>
 
+#include <cmath>
 #include <iostream>
 #include <sstream>
 
@@ -32,27 +33,22 @@ namespace fastdds {
 
 Publisher::Publisher(
         Participant* participant,
+        ConversionContext* conversion,
         const std::string& topic_name,
         const xtypes::DynamicType& message_type,
-        const YAML::Node& config)
+        const YAML::Node& config,
+        WriterCreated writer_created)
     : participant_(participant)
+    , conversion_(conversion)
+    , dds_publisher_(nullptr)
+    , dds_topic_(nullptr)
+    , dds_datawriter_(nullptr)
+    , writer_created_(std::move(writer_created))
+    , dynamic_data_(nullptr)
     , topic_name_(topic_name)
+    , message_type_(message_type)
     , logger_("is::sh::FastDDS::Publisher")
 {
-    fastrtps::types::DynamicTypeBuilder* builder = Conversion::create_builder(message_type);
-
-    if (builder != nullptr)
-    {
-        participant->register_dynamic_type(topic_name, message_type.name(), builder);
-    }
-    else
-    {
-        throw DDSMiddlewareException(
-                  logger_, "Cannot create builder for type " + message_type.name());
-    }
-
-    dynamic_data_ = participant->create_dynamic_data(topic_name);
-
     // Retrieve DDS participant
     ::fastdds::dds::DomainParticipant* dds_participant = participant->get_dds_participant();
     if (!dds_participant)
@@ -61,14 +57,9 @@ Publisher::Publisher(
                   logger_, "Trying to create a publisher without a DDS participant!");
     }
 
-    // Create DDS publisher with default publisher QoS
-    dds_publisher_ = dds_participant->create_publisher(::fastdds::dds::PUBLISHER_QOS_DEFAULT);
-    if (dds_publisher_)
-    {
-        logger_ << utils::Logger::Level::DEBUG
-                << "Created Fast DDS publisher for topic '" << topic_name << "'" << std::endl;
-    }
-    else
+    // Get the DDS publisher shared by the topics in the configured partitions
+    dds_publisher_ = participant->get_dds_publisher(participant->get_partition_qos(config["partitions"]));
+    if (!dds_publisher_)
     {
         std::ostringstream err;
         err << "Fast DDS publisher for topic '" << topic_name << "' was not created";
@@ -76,53 +67,108 @@ Publisher::Publisher(
         throw DDSMiddlewareException(logger_, err.str());
     }
 
-    // Create DDS topic
-    auto topic_description = dds_participant->lookup_topicdescription(topic_name);
-    if (!topic_description)
+    // DDS datawriter QoS
+    datawriter_qos_ = ::fastdds::dds::DATAWRITER_QOS_DEFAULT;
+    if (config["service_instance_name"])
+    {
+        fastrtps::rtps::Property instance_property;
+        instance_property.name("dds.rpc.service_instance_name");
+        instance_property.value(config["service_instance_name"].as<std::string>());
+        datawriter_qos_.properties().properties().emplace_back(std::move(instance_property));
+    }
+
+    if (config["fields"])
     {
-        dds_topic_ = dds_participant->create_topic(
-            topic_name, message_type.name(), ::fastdds::dds::TOPIC_QOS_DEFAULT);
-        if (dds_topic_)
+        projection_ = Conversion::create_projection(
+            message_type, config["fields"].as<std::vector<std::string> >());
+    }
+
+    if (config["max_age"])
+    {
+        const double max_age = config["max_age"].as<double>();
+        if (!(0 < max_age) || std::isinf(max_age))
         {
-            logger_ << utils::Logger::Level::DEBUG
-                    << "Created Fast DDS topic '" << topic_name << "' with type '"
-                    << message_type.name() << "'" << std::endl;
+            throw DDSMiddlewareException(
+                      logger_, "Topic '" + topic_name + "' has an invalid 'max_age'");
         }
-        else
-        {
-            std::ostringstream err;
-            err << "Fast DDS topic '" << topic_name << "' with type '"
-                << message_type.name() << "' was not created";
 
-            throw DDSMiddlewareException(logger_, err.str());
-        }
+        // Samples not delivered within their useful life are removed from the histories
+        datawriter_qos_.lifespan().duration = fastrtps::Duration_t(max_age);
+    }
+
+    if (config["lazy"] && config["lazy"].as<bool>())
+    {
+        // Nobody would read the samples written before a remote subscriber is discovered
+        participant->add_lazy_endpoint(topic_name, true, this, [this]()
+                {
+                    create_datawriter();
+                });
+
+        logger_ << utils::Logger::Level::DEBUG
+                << "Fast DDS datawriter for topic '" << topic_name
+                << "' will be created when a remote subscriber is discovered" << std::endl;
     }
     else
     {
-        dds_topic_ = static_cast<::fastdds::dds::Topic*>(topic_description);
+        participant->create_endpoint(this, [this]()
+                {
+                    create_datawriter();
+                });
     }
+}
 
-    // Create DDS datawriter
-    ::fastdds::dds::DataWriterQos datawriter_qos = ::fastdds::dds::DATAWRITER_QOS_DEFAULT;
-    if (config["service_instance_name"])
+void Publisher::create_datawriter()
+{
+    std::unique_lock<std::mutex> lock(data_mtx_);
+
+    fastrtps::types::DynamicTypeBuilder* builder = conversion_->create_builder(message_type_);
+
+    if (builder != nullptr)
     {
-        fastrtps::rtps::Property instance_property;
-        instance_property.name("dds.rpc.service_instance_name");
-        instance_property.value(config["service_instance_name"].as<std::string>());
-        datawriter_qos.properties().properties().emplace_back(std::move(instance_property));
+        participant_->register_dynamic_type(
+            topic_name_, message_type_.name(), builder, Conversion::is_bounded(message_type_));
+    }
+    else
+    {
+        throw DDSMiddlewareException(
+                  logger_, "Cannot create builder for type " + message_type_.name());
+    }
+
+    const std::string& type_name = participant_->get_topic_type(topic_name_);
+
+    dynamic_data_ = participant_->create_dynamic_data(topic_name_);
+
+    // Create DDS topic
+    dds_topic_ = participant_->get_dds_topic(topic_name_, type_name);
+    if (!dds_topic_)
+    {
+        std::ostringstream err;
+        err << "Fast DDS topic '" << topic_name_ << "' with type '"
+            << type_name << "' was not created";
+
+        throw DDSMiddlewareException(logger_, err.str());
     }
 
-    dds_datawriter_ = dds_publisher_->create_datawriter(dds_topic_, datawriter_qos, this);
+    // Endpoints announced through static discovery are identified by their user defined ID
+    datawriter_qos_.endpoint().user_defined_id =
+            participant_->add_static_writer(dds_topic_, dds_publisher_, datawriter_qos_);
+
+    dds_datawriter_ = dds_publisher_->create_datawriter(dds_topic_, datawriter_qos_, this);
     if (dds_datawriter_)
     {
         logger_ << utils::Logger::Level::DEBUG
-                << "Created Fast DDS datawriter for topic '" << topic_name << "'" << std::endl;
+                << "Created Fast DDS datawriter for topic '" << topic_name_ << "'" << std::endl;
         participant_->associate_topic_to_dds_entity(dds_topic_, dds_datawriter_);
+
+        if (writer_created_)
+        {
+            writer_created_(dds_datawriter_->guid());
+        }
     }
     else
     {
         std::ostringstream err;
-        err << "Fast DDS datawriter for topic '" << topic_name << "' was not created";
+        err << "Fast DDS datawriter for topic '" << topic_name_ << "' was not created";
 
         throw DDSMiddlewareException(logger_, err.str());
     }
@@ -130,14 +176,24 @@ Publisher::Publisher(
 
 Publisher::~Publisher()
 {
+    participant_->cancel_lazy_endpoint(this);
+
     std::unique_lock<std::mutex> lock(data_mtx_);
-    participant_->delete_dynamic_data(dynamic_data_);
+    if (nullptr != dynamic_data_)
+    {
+        participant_->delete_dynamic_data(dynamic_data_);
+    }
+
+    if (nullptr == dds_datawriter_)
+    {
+        // Deferred, and never created
+        return;
+    }
 
     bool delete_topic = participant_->dissociate_topic_from_dds_entity(dds_topic_, dds_datawriter_);
 
     dds_datawriter_->set_listener(nullptr);
     dds_publisher_->delete_datawriter(dds_datawriter_);
-    participant_->get_dds_participant()->delete_publisher(dds_publisher_);
 
     if (delete_topic)
     {
@@ -154,7 +210,14 @@ bool Publisher::publish(
             << "Sending message from Integration Service to DDS for topic '" << topic_name_ << "': "
             << "[[ " << message << " ]]" << std::endl;
 
-    bool success = Conversion::xtypes_to_fastdds(message, dynamic_data_);
+    if (nullptr == dds_datawriter_)
+    {
+        // Lazy, and no remote subscriber has been discovered yet; or deferred until the system
+        // starts spinning (see the startup_threads option)
+        return true;
+    }
+
+    bool success = Conversion::xtypes_to_fastdds(message, dynamic_data_, projection_.get());
     if (success)
     {
         success = dds_datawriter_->write(static_cast<void*>(dynamic_data_));
@@ -176,7 +239,7 @@ const std::string& Publisher::topic_name() const
 
 const fastrtps::rtps::InstanceHandle_t Publisher::get_dds_instance_handle() const
 {
-    return dds_datawriter_->get_instance_handle();
+    return dds_datawriter_ ? dds_datawriter_->get_instance_handle() : fastrtps::rtps::InstanceHandle_t();
 }
 
 void Publisher::on_publication_matched(
@@ -26,6 +26,9 @@
 #include <is/utils/Log.hpp>
 
 #include <fastdds/dds/publisher/Publisher.hpp>
+#include <fastdds/dds/publisher/qos/DataWriterQos.hpp>
+
+#include <functional>
 
 namespace fastdds = eprosima::fastdds;
 
@@ -34,11 +37,21 @@ namespace is {
 namespace sh {
 namespace fastdds {
 
+/**
+ * @brief Forward declaration.
+ */
+class ConversionContext;
+
 /**
  * @brief Forward declaration.
  */
 class Participant;
 
+/**
+ * @brief Forward declaration.
+ */
+struct Projection;
+
 /**
  * @class Publisher
  *        This class represents a <a href="https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/publisher/publisher.html">
@@ -60,12 +73,17 @@ class Publisher
 {
 public:
 
+    using WriterCreated = std::function<void (const fastrtps::rtps::GUID_t& guid)>;
+
     /**
      * @brief Construct a new Publisher object.
      *
      * @param[in] participant The associated *Integration Service* Participant,
      *            that holds this Publisher.
      *
+     * @param[in] conversion The conversion context of the system, which keeps the
+     *            *Fast DDS* builders of its types.
+     *
      * @param[in] topic_name The topic that this DDS publisher will send data to.
      *
      * @param[in] message_type A dynamic type definition of the topic's type.
@@ -73,14 +91,25 @@ public:
      * @param[in] config Specific configuration regarding this publisher, in *YAML* format.
      *            Allowed fields are:
      *            - `service_instance_name`: Specify the DDS RPC service instance name property.
+     *            - `max_age`: Lifespan, in seconds, of the samples written by this publisher.
+     *            - `fields`: List of members, as paths with dots through nested structures,
+     *              copied from the *Integration Service* messages. The rest keep their default value.
+     *            - `lazy`: Defer the creation of the DataWriter until a remote subscriber of the topic
+     *              is discovered. Messages published meanwhile are discarded.
+     *
+     * @param[in] writer_created Optional function called with the GUID of the DataWriter
+     *            once it is created, which may happen after the construction for lazy and
+     *            deferred DataWriters.
      *
      * @throws DDSMiddlewareException if some error occurs while creating the *Fast DDS* publisher.
      */
     Publisher(
             Participant* participant,
+            ConversionContext* conversion,
             const std::string& topic_name,
             const xtypes::DynamicType& message_type,
-            const YAML::Node& config);
+            const YAML::Node& config,
+            WriterCreated writer_created = nullptr);
 
     // TODO(@jamoralp): Create publisher based on XML profiles?
 
@@ -136,6 +165,14 @@ public:
 
 private:
 
+    /**
+     * @brief Register the topic type and create the DDS topic, if needed, and the DataWriter.
+     *
+     * @throws DDSMiddlewareException if the type could not be registered or some DDS entity
+     *         could not be created.
+     */
+    void create_datawriter();
+
     /**
      * @brief Inherited from *DataWriterListener*.
      */
@@ -147,14 +184,20 @@ private:
      * Class members.
      */
     Participant* participant_;
+    ConversionContext* conversion_;
     ::fastdds::dds::Publisher* dds_publisher_;
     ::fastdds::dds::Topic* dds_topic_;
     ::fastdds::dds::DataWriter* dds_datawriter_;
+    ::fastdds::dds::DataWriterQos datawriter_qos_;
+    WriterCreated writer_created_;
 
     fastrtps::types::DynamicData* dynamic_data_;
     std::mutex data_mtx_;
 
+    std::shared_ptr<Projection> projection_;
+
     const std::string topic_name_;
+    const xtypes::DynamicType& message_type_;
 
     utils::Logger logger_;
 };
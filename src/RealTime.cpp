@@ -0,0 +1,253 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "RealTime.hpp"
+
+#ifdef __linux__
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif //  ifdef __linux__
+
+#include <cerrno>
+#include <cstring>
+#include <memory>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace fastdds {
+
+namespace {
+
+#ifndef __linux__
+constexpr int SCHED_OTHER = 0;
+constexpr int SCHED_FIFO = 1;
+constexpr int SCHED_RR = 2;
+#endif //  ifndef __linux__
+
+// Stack touched by each configured thread, so that it is already mapped (and locked) when needed
+constexpr std::size_t PREFAULT_STACK_SIZE = 64 * 1024;
+
+void prefault_stack()
+{
+    unsigned char buffer[PREFAULT_STACK_SIZE];
+    volatile unsigned char* page = buffer;
+    for (std::size_t i = 0; i < PREFAULT_STACK_SIZE; i += 1024)
+    {
+        page[i] = 0;
+    }
+}
+
+} //  anonymous namespace
+
+RealTime::RealTime(
+        const YAML::Node& config)
+    : policy_(SCHED_OTHER)
+    , priority_(0)
+    , lock_memory_(false)
+    , prefault_heap_kb_(0)
+    , pool_samples_(0)
+    , logger_("is::sh::FastDDS::RealTime")
+{
+    if (config["cpus"])
+    {
+        cpus_ = config["cpus"].as<std::vector<int> >();
+
+        for (int cpu : cpus_)
+        {
+#ifdef __linux__
+            if (0 > cpu || CPU_SETSIZE <= cpu)
+#else
+            if (0 > cpu)
+#endif //  ifdef __linux__
+            {
+                throw DDSMiddlewareException(
+                          logger_, "Realtime CPU index " + std::to_string(cpu) + " is out of range");
+            }
+        }
+    }
+
+    if (config["scheduler"])
+    {
+        const std::string scheduler = config["scheduler"].as<std::string>();
+        if ("fifo" == scheduler)
+        {
+            policy_ = SCHED_FIFO;
+        }
+        else if ("rr" == scheduler)
+        {
+            policy_ = SCHED_RR;
+        }
+        else if ("other" != scheduler)
+        {
+            throw DDSMiddlewareException(
+                      logger_, "Unknown realtime scheduler '" + scheduler
+                      + "'. Allowed values are 'other', 'fifo' and 'rr'");
+        }
+    }
+
+    if (config["priority"])
+    {
+        priority_ = config["priority"].as<int>();
+
+#ifdef __linux__
+        if (SCHED_OTHER != policy_ && (priority_ < sched_get_priority_min(policy_)
+                || priority_ > sched_get_priority_max(policy_)))
+        {
+            throw DDSMiddlewareException(
+                      logger_, "Realtime priority " + std::to_string(priority_)
+                      + " is out of the range allowed by the scheduler");
+        }
+#endif //  ifdef __linux__
+    }
+
+    if (config["lock_memory"])
+    {
+        lock_memory_ = config["lock_memory"].as<bool>();
+    }
+
+    if (config["prefault_heap_kb"])
+    {
+        prefault_heap_kb_ = config["prefault_heap_kb"].as<std::size_t>();
+    }
+
+    if (config["pool_samples"])
+    {
+        pool_samples_ = config["pool_samples"].as<std::size_t>();
+    }
+
+#ifndef __linux__
+    logger_ << utils::Logger::Level::WARN
+            << "CPU affinity, scheduling and memory locking settings are only supported on Linux, "
+            << "they will be ignored" << std::endl;
+#endif //  ifndef __linux__
+}
+
+void RealTime::lock_memory() const
+{
+    if (!lock_memory_)
+    {
+        return;
+    }
+
+#ifdef __linux__
+    if (0 != mlockall(MCL_CURRENT | MCL_FUTURE))
+    {
+        logger_ << utils::Logger::Level::WARN
+                << "Cannot lock the process memory: " << std::strerror(errno) << std::endl;
+        return;
+    }
+
+    // Keep freed memory inside the process, instead of giving it back to the system;
+    // and serve every allocation from the heap, so that it stays locked and pre-faulted.
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+
+    if (0 < prefault_heap_kb_)
+    {
+        const std::size_t size = prefault_heap_kb_ * 1024;
+        const std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+
+        std::unique_ptr<unsigned char[]> heap(new unsigned char[size]);
+        volatile unsigned char* page = heap.get();
+        for (std::size_t i = 0; i < size; i += page_size)
+        {
+            page[i] = 0;
+        }
+    }
+
+    logger_ << utils::Logger::Level::INFO
+            << "Process memory locked, with " << prefault_heap_kb_ << " KB of pre-faulted heap" << std::endl;
+#endif //  ifdef __linux__
+}
+
+void RealTime::configure_current_thread() const
+{
+#ifdef __linux__
+    if (!cpus_.empty())
+    {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        for (int cpu : cpus_)
+        {
+            CPU_SET(cpu, &cpu_set);
+        }
+
+        int error = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+        if (0 != error)
+        {
+            logger_ << utils::Logger::Level::WARN
+                    << "Cannot set the CPU affinity of a thread: " << std::strerror(error) << std::endl;
+        }
+    }
+
+    if (SCHED_OTHER != policy_)
+    {
+        sched_param param;
+        std::memset(&param, 0, sizeof(param));
+        param.sched_priority = priority_;
+
+        int error = pthread_setschedparam(pthread_self(), policy_, &param);
+        if (0 != error)
+        {
+            logger_ << utils::Logger::Level::WARN
+                    << "Cannot set the scheduling policy of a thread: " << std::strerror(error) << std::endl;
+        }
+    }
+
+    if (lock_memory_)
+    {
+        prefault_stack();
+    }
+#endif //  ifdef __linux__
+}
+
+std::size_t RealTime::pool_samples() const
+{
+    return pool_samples_;
+}
+
+#if FASTRTPS_VERSION_MINOR >= 12
+::fastdds::rtps::ThreadSettings RealTime::thread_settings() const
+{
+    ::fastdds::rtps::ThreadSettings settings;
+
+    for (int cpu : cpus_)
+    {
+        if (0 <= cpu && cpu < 64)
+        {
+            settings.affinity |= (uint64_t(1) << cpu);
+        }
+    }
+
+    if (SCHED_OTHER != policy_)
+    {
+        settings.scheduling_policy = policy_;
+        settings.priority = priority_;
+    }
+
+    return settings;
+}
+#endif //  if FASTRTPS_VERSION_MINOR >= 12
+
+} //  namespace fastdds
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
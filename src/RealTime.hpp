@@ -0,0 +1,125 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _IS_SH_FASTDDS__INTERNAL__REALTIME_HPP_
+#define _IS_SH_FASTDDS__INTERNAL__REALTIME_HPP_
+
+#include "DDSMiddlewareException.hpp"
+
+#include <fastrtps/config.h>
+#if FASTRTPS_VERSION_MINOR >= 12
+#include <fastdds/rtps/attributes/ThreadSettings.hpp>
+#endif //  if FASTRTPS_VERSION_MINOR >= 12
+
+#include <is/utils/Log.hpp>
+
+#include <yaml-cpp/yaml.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#if FASTRTPS_VERSION_MINOR >= 12
+namespace fastdds = eprosima::fastdds;
+#endif //  if FASTRTPS_VERSION_MINOR >= 12
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace fastdds {
+
+/**
+ * @class RealTime
+ *        Real-time settings applied to the threads that handle the DDS traffic of this
+ *        *Integration Service* is::SystemHandle, and to the process memory.
+ *
+ * @details The settings are taken from the `realtime` section of the system configuration.
+ *          CPU affinity, scheduling class and memory locking are only supported on Linux;
+ *          on other platforms they are ignored with a warning. If the process lacks the
+ *          required privileges (e.g. `CAP_SYS_NICE` or `CAP_IPC_LOCK`), a warning is printed
+ *          and the thread or process keeps its previous settings.
+ */
+class RealTime
+{
+public:
+
+    /**
+     * @brief Construct a new RealTime object from the *YAML* configuration.
+     *
+     * @param[in] config The `realtime` configuration node. Allowed fields are:
+     *            - `cpus`: List of CPU cores the threads are pinned to.
+     *            - `scheduler`: Scheduling class, either `other` (default), `fifo` or `rr`.
+     *            - `priority`: Scheduling priority, for the `fifo` and `rr` classes.
+     *            - `lock_memory`: Whether the process memory is locked in RAM. Defaults to `false`.
+     *            - `prefault_heap_kb`: Amount of heap memory touched and kept by the allocator
+     *              when locking memory, so that later allocations do not page fault.
+     *            - `pool_samples`: Number of samples preallocated by each subscription.
+     *
+     * @throws DDSMiddlewareException If some field has an invalid value.
+     */
+    RealTime(
+            const YAML::Node& config);
+
+    /**
+     * @brief Lock the current and future process memory in RAM, and pre-fault the heap,
+     *        if `lock_memory` was enabled.
+     */
+    void lock_memory() const;
+
+    /**
+     * @brief Apply the CPU affinity and scheduling settings to the calling thread;
+     *        and pre-fault its stack, if `lock_memory` was enabled.
+     */
+    void configure_current_thread() const;
+
+    /**
+     * @brief Get the number of samples each subscription must preallocate.
+     *
+     * @returns The pool size.
+     */
+    std::size_t pool_samples() const;
+
+#if FASTRTPS_VERSION_MINOR >= 12
+    /**
+     * @brief Get the equivalent *Fast DDS* thread settings, used for its internal threads.
+     *
+     * @returns The thread settings.
+     */
+    ::fastdds::rtps::ThreadSettings thread_settings() const;
+#endif //  if FASTRTPS_VERSION_MINOR >= 12
+
+private:
+
+    /**
+     * Class members.
+     */
+    std::vector<int> cpus_;
+    int policy_;
+    int priority_;
+    bool lock_memory_;
+    std::size_t prefault_heap_kb_;
+    std::size_t pool_samples_;
+
+    mutable utils::Logger logger_;
+};
+
+} //  namespace fastdds
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+#endif //  _IS_SH_FASTDDS__INTERNAL__REALTIME_HPP_
@@ -0,0 +1,232 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ReceptionWaitSet.hpp"
+
+#include <fastrtps/config.h>
+
+#if FASTRTPS_VERSION_MINOR >= 4
+#include <fastdds/dds/core/condition/GuardCondition.hpp>
+#include <fastdds/dds/core/condition/StatusCondition.hpp>
+#include <fastdds/dds/core/condition/WaitSet.hpp>
+#include <fastdds/dds/core/status/StatusMask.hpp>
+#endif //  if FASTRTPS_VERSION_MINOR >= 4
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace fastdds {
+
+struct ReceptionWaitSet::Worker
+{
+#if FASTRTPS_VERSION_MINOR >= 4
+    ::fastdds::dds::WaitSet waitset;
+    ::fastdds::dds::GuardCondition stop_condition;
+#endif //  if FASTRTPS_VERSION_MINOR >= 4
+
+    // Locked while a listener is being triggered, so that readers can be safely detached
+    std::mutex mtx;
+    std::map<::fastdds::dds::DataReader*, ::fastdds::dds::DataReaderListener*> readers;
+    std::thread thread;
+};
+
+ReceptionWaitSet::ReceptionWaitSet(
+        std::size_t threads,
+        std::function<void()> thread_init)
+    : thread_init_(std::move(thread_init))
+    , next_worker_(0)
+    , logger_("is::sh::FastDDS::ReceptionWaitSet")
+{
+#if FASTRTPS_VERSION_MINOR >= 4
+    if (0 == threads)
+    {
+        threads = 1;
+    }
+
+    workers_.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i)
+    {
+        workers_.emplace_back(new Worker());
+        workers_.back()->waitset.attach_condition(workers_.back()->stop_condition);
+    }
+
+    // Launched once every worker exists, as workers_ must not be resized while they run
+    for (std::unique_ptr<Worker>& worker : workers_)
+    {
+        worker->thread = std::thread(&ReceptionWaitSet::worker_function, this, std::ref(*worker));
+    }
+#else
+    (void)threads;
+    throw DDSMiddlewareException(
+              logger_, "WaitSet based reception requires Fast DDS v2.4.0 or newer");
+#endif //  if FASTRTPS_VERSION_MINOR >= 4
+}
+
+ReceptionWaitSet::~ReceptionWaitSet()
+{
+#if FASTRTPS_VERSION_MINOR >= 4
+    for (std::unique_ptr<Worker>& worker : workers_)
+    {
+        worker->stop_condition.set_trigger_value(true);
+    }
+
+    for (std::unique_ptr<Worker>& worker : workers_)
+    {
+        if (worker->thread.joinable())
+        {
+            worker->thread.join();
+        }
+
+        for (auto& pair : worker->readers)
+        {
+            worker->waitset.detach_condition(pair.first->get_statuscondition());
+        }
+        worker->waitset.detach_condition(worker->stop_condition);
+    }
+#endif //  if FASTRTPS_VERSION_MINOR >= 4
+}
+
+void ReceptionWaitSet::attach(
+        ::fastdds::dds::DataReader* reader,
+        ::fastdds::dds::DataReaderListener* listener)
+{
+#if FASTRTPS_VERSION_MINOR >= 4
+    const std::size_t index = next_worker_++ % workers_.size();
+    Worker& worker = *workers_[index];
+
+    {
+        std::unique_lock<std::mutex> lock(worker.mtx);
+        worker.readers[reader] = listener;
+    }
+
+    ::fastdds::dds::StatusCondition& condition = reader->get_statuscondition();
+    condition.set_enabled_statuses(
+        ::fastdds::dds::StatusMask::data_available() << ::fastdds::dds::StatusMask::subscription_matched());
+    worker.waitset.attach_condition(condition);
+
+    logger_ << utils::Logger::Level::DEBUG
+            << "Attached DataReader for topic '" << reader->get_topicdescription()->get_name()
+            << "' to reception thread " << index << std::endl;
+#else
+    (void)reader;
+    (void)listener;
+#endif //  if FASTRTPS_VERSION_MINOR >= 4
+}
+
+void ReceptionWaitSet::detach(
+        ::fastdds::dds::DataReader* reader)
+{
+#if FASTRTPS_VERSION_MINOR >= 4
+    for (std::unique_ptr<Worker>& worker : workers_)
+    {
+        std::unique_lock<std::mutex> lock(worker->mtx);
+        if (worker->readers.erase(reader) > 0)
+        {
+            worker->waitset.detach_condition(reader->get_statuscondition());
+            return;
+        }
+    }
+#else
+    (void)reader;
+#endif //  if FASTRTPS_VERSION_MINOR >= 4
+}
+
+std::size_t ReceptionWaitSet::size() const
+{
+    return workers_.size();
+}
+
+void ReceptionWaitSet::worker_function(
+        Worker& worker)
+{
+#if FASTRTPS_VERSION_MINOR >= 4
+    if (thread_init_)
+    {
+        thread_init_();
+    }
+
+    ::fastdds::dds::ConditionSeq active_conditions;
+
+    while (true)
+    {
+        active_conditions.clear();
+        worker.waitset.wait(active_conditions, fastrtps::c_TimeInfinite);
+
+        if (worker.stop_condition.get_trigger_value())
+        {
+            break;
+        }
+
+        std::unique_lock<std::mutex> lock(worker.mtx);
+
+        for (::fastdds::dds::Condition* condition : active_conditions)
+        {
+            if (&worker.stop_condition == condition)
+            {
+                continue;
+            }
+
+            ::fastdds::dds::DataReader* reader = static_cast<::fastdds::dds::DataReader*>(
+                static_cast<::fastdds::dds::StatusCondition*>(condition)->get_entity());
+
+            auto it = worker.readers.find(reader);
+            if (worker.readers.end() == it)
+            {
+                // Detached while waiting
+                continue;
+            }
+
+            ::fastdds::dds::DataReaderListener* listener = it->second;
+            const ::fastdds::dds::StatusMask changes = reader->get_status_changes();
+
+            if (changes.is_active(::fastdds::dds::StatusMask::subscription_matched()))
+            {
+                ::fastdds::dds::SubscriptionMatchedStatus status;
+                reader->get_subscription_matched_status(status);
+                listener->on_subscription_matched(reader, status);
+            }
+
+            if (changes.is_active(::fastdds::dds::StatusMask::data_available()))
+            {
+                // Taking resets the data available status, even if some samples remain unread.
+                // Keep on triggering the listener as long as it makes progress.
+                uint64_t unread = 0;
+                uint64_t remaining = reader->get_unread_count();
+                do
+                {
+                    listener->on_data_available(reader);
+                    unread = remaining;
+                    remaining = reader->get_unread_count();
+                }
+                while (0 < remaining && remaining < unread);
+            }
+        }
+    }
+#else
+    (void)worker;
+#endif //  if FASTRTPS_VERSION_MINOR >= 4
+}
+
+} //  namespace fastdds
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
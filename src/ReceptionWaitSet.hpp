@@ -0,0 +1,150 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _IS_SH_FASTDDS__INTERNAL__RECEPTIONWAITSET_HPP_
+#define _IS_SH_FASTDDS__INTERNAL__RECEPTIONWAITSET_HPP_
+
+#include "DDSMiddlewareException.hpp"
+
+#include <fastdds/dds/subscriber/DataReader.hpp>
+#include <fastdds/dds/subscriber/DataReaderListener.hpp>
+
+#include <is/utils/Log.hpp>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace fastdds = eprosima::fastdds;
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace fastdds {
+
+/**
+ * @class ReceptionWaitSet
+ *        Set of threads, owned by the *Integration Service* system handle, which wait on
+ *        <a href="https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/core/waitsets/waitsets.html">
+ *        Fast DDS WaitSets</a> for the status changes of the attached DataReaders.
+ *
+ * @details DataReaders attached to a ReceptionWaitSet are created without listener, so that the
+ *          Fast DDS receive threads never run bridge code. Instead, each reader is assigned to one
+ *          of the threads of this class, which waits on the reader's *StatusCondition* and,
+ *          when data is available or the reader gets matched or unmatched, triggers the
+ *          corresponding *DataReaderListener* method of the attached object.
+ *
+ *          Each thread owns its own *WaitSet*, since Fast DDS allows one waiting thread per WaitSet.
+ *          WaitSets are available since *Fast DDS* `v2.4.0`.
+ */
+class ReceptionWaitSet
+{
+public:
+
+    /**
+     * @brief Construct a new ReceptionWaitSet, and launch its threads.
+     *
+     * @param[in] threads Number of waiting threads. If `0`, one thread is used.
+     *
+     * @param[in] thread_init Optional function run by each thread before waiting,
+     *            e.g. to set its CPU affinity or scheduling priority.
+     *
+     * @throws DDSMiddlewareException If the *Fast DDS* version does not provide WaitSets.
+     */
+    ReceptionWaitSet(
+            std::size_t threads,
+            std::function<void()> thread_init = nullptr);
+
+    /**
+     * @brief Destroy the ReceptionWaitSet. Its threads are stopped and joined.
+     */
+    ~ReceptionWaitSet();
+
+    /**
+     * @brief ReceptionWaitSet shall not be copy constructible.
+     */
+    ReceptionWaitSet(
+            const ReceptionWaitSet& /*rhs*/) = delete;
+
+    /**
+     * @brief ReceptionWaitSet shall not be copy assignable.
+     */
+    ReceptionWaitSet& operator = (
+            const ReceptionWaitSet& /*rhs*/) = delete;
+
+    /**
+     * @brief Start waiting for the data and matching events of a DataReader.
+     *
+     * @param[in] reader The DataReader, which should have been created without listener.
+     *
+     * @param[in] listener The object whose `on_data_available` and `on_subscription_matched`
+     *            methods are triggered, from one of the threads of this class.
+     */
+    void attach(
+            ::fastdds::dds::DataReader* reader,
+            ::fastdds::dds::DataReaderListener* listener);
+
+    /**
+     * @brief Stop waiting for the events of a DataReader.
+     *
+     * @details When this method returns, the listener attached alongside the reader
+     *          is not being triggered, and it will never be triggered again.
+     *
+     * @param[in] reader The DataReader to detach.
+     */
+    void detach(
+            ::fastdds::dds::DataReader* reader);
+
+    /**
+     * @brief Get the number of waiting threads.
+     *
+     * @returns The number of threads.
+     */
+    std::size_t size() const;
+
+private:
+
+    /**
+     * @brief A waiting thread, alongside its WaitSet and its attached readers.
+     */
+    struct Worker;
+
+    /**
+     * @brief Waiting thread main loop.
+     *
+     * @param[in] worker The state of the thread.
+     */
+    void worker_function(
+            Worker& worker);
+
+    /**
+     * Class members.
+     */
+    std::function<void()> thread_init_;
+    std::vector<std::unique_ptr<Worker> > workers_;
+    std::atomic<std::size_t> next_worker_;
+
+    utils::Logger logger_;
+};
+
+} //  namespace fastdds
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+#endif //  _IS_SH_FASTDDS__INTERNAL__RECEPTIONWAITSET_HPP_
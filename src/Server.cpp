@@ -41,11 +41,16 @@ namespace fastdds {
 
 Server::Server(
         Participant* participant,
+        ConversionContext* conversion,
         const std::string& service_name,
         const xtypes::DynamicType& request_type,
         const xtypes::DynamicType& reply_type,
-        const YAML::Node& config)
+        const YAML::Node& config,
+        ReceptionWaitSet* waitset,
+        const RealTime* realtime)
     : participant_(participant)
+    , waitset_(waitset)
+    , realtime_(realtime)
     , service_name_(service_name)
     , request_entities_(request_type)
     , reply_entities_(reply_type)
@@ -60,8 +65,8 @@ Server::Server(
     add_config(config);
 
     // Create DynamicData
-    DynamicTypeBuilder* builder_request = Conversion::create_builder(request_type);
-    DynamicTypeBuilder* builder_reply = Conversion::create_builder(reply_type);
+    DynamicTypeBuilder* builder_request = conversion->create_builder(request_type);
+    DynamicTypeBuilder* builder_reply = conversion->create_builder(reply_type);
 
     if (builder_request != nullptr)
     {
@@ -98,16 +103,9 @@ Server::Server(
 
     // Create request entities
     {
-        // Create DDS publisher
-        request_entities_.dds_publisher = dds_participant->create_publisher(
-            ::fastdds::dds::PUBLISHER_QOS_DEFAULT);
-        if (request_entities_.dds_publisher)
-        {
-            logger_ << utils::Logger::Level::DEBUG
-                    << "Created Fast DDS publisher for service '"
-                    << service_name << "' request" << std::endl;
-        }
-        else
+        // Get the DDS publisher shared with the topics in the default partition
+        request_entities_.dds_publisher = participant->get_dds_publisher(::fastdds::dds::PartitionQosPolicy());
+        if (!request_entities_.dds_publisher)
         {
             std::ostringstream err;
             err << "Fast DDS publisher for service '"
@@ -153,6 +151,10 @@ Server::Server(
             datawriter_qos.properties().properties().emplace_back(std::move(instance_property));
         }
 
+        // Endpoints announced through static discovery are identified by their user defined ID
+        datawriter_qos.endpoint().user_defined_id = participant->add_static_writer(
+            request_entities_.dds_topic, request_entities_.dds_publisher, datawriter_qos);
+
         request_entities_.dds_datawriter = request_entities_.dds_publisher->create_datawriter(
             request_entities_.dds_topic, datawriter_qos, this);
 
@@ -176,16 +178,9 @@ Server::Server(
 
     // Create reply entities
     {
-        // Create DDS subscriber
-        reply_entities_.dds_subscriber = dds_participant->create_subscriber(
-            ::fastdds::dds::SUBSCRIBER_QOS_DEFAULT);
-        if (reply_entities_.dds_subscriber)
-        {
-            logger_ << utils::Logger::Level::DEBUG
-                    << "Created Fast DDS subscriber for service '"
-                    << service_name << "' reply" << std::endl;
-        }
-        else
+        // Get the DDS subscriber shared with the topics in the default partition
+        reply_entities_.dds_subscriber = participant->get_dds_subscriber(::fastdds::dds::PartitionQosPolicy());
+        if (!reply_entities_.dds_subscriber)
         {
             std::ostringstream err;
             err << "Fast DDS subscriber for service '"
@@ -234,8 +229,13 @@ Server::Server(
             datareader_qos.properties().properties().emplace_back(std::move(instance_property));
         }
 
+        // Endpoints announced through static discovery are identified by their user defined ID
+        datareader_qos.endpoint().user_defined_id = participant->add_static_reader(
+            reply_entities_.dds_topic, reply_entities_.dds_subscriber, datareader_qos);
+
+        // When a WaitSet drives the reception, the listener is not set
         reply_entities_.dds_datareader = reply_entities_.dds_subscriber->create_datareader(
-            reply_entities_.dds_topic, datareader_qos, this);
+            reply_entities_.dds_topic, datareader_qos, nullptr == waitset_ ? this : nullptr);
 
         if (reply_entities_.dds_datareader)
         {
@@ -254,6 +254,12 @@ Server::Server(
             throw (DDSMiddlewareException(logger_, err.str()));
         }
     }
+
+    // Attached last, so that the WaitSet never dispatches to a Server whose construction failed
+    if (nullptr != waitset_)
+    {
+        waitset_->attach(reply_entities_.dds_datareader, this);
+    }
 }
 
 Server::~Server()
@@ -261,6 +267,11 @@ Server::~Server()
     logger_ << utils::Logger::Level::INFO
             << "Waiting for current processing messages before quitting" << std::endl;
 
+    if (nullptr != waitset_)
+    {
+        waitset_->detach(reply_entities_.dds_datareader);
+    }
+
     {
         std::unique_lock<std::mutex> lock(cleaner_mtx_);
         stop_cleaner_ = true;
@@ -285,7 +296,6 @@ Server::~Server()
             request_entities_.dds_topic, request_entities_.dds_datawriter);
 
         request_entities_.dds_publisher->delete_datawriter(request_entities_.dds_datawriter);
-        dds_participant->delete_publisher(request_entities_.dds_publisher);
 
         if (delete_topic)
         {
@@ -301,7 +311,6 @@ Server::~Server()
             reply_entities_.dds_topic, reply_entities_.dds_datareader);
 
         reply_entities_.dds_subscriber->delete_datareader(reply_entities_.dds_datareader);
-        dds_participant->delete_subscriber(reply_entities_.dds_subscriber);
 
         if (delete_topic)
         {
@@ -573,6 +582,11 @@ void Server::on_data_available(
 void Server::receive(
         fastrtps::rtps::SampleIdentity sample_id)
 {
+    if (nullptr != realtime_)
+    {
+        realtime_->configure_current_thread();
+    }
+
     std::shared_ptr<void> call_handle;
 
     {
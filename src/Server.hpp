@@ -20,6 +20,8 @@
 
 #include "DDSMiddlewareException.hpp"
 #include "Participant.hpp"
+#include "RealTime.hpp"
+#include "ReceptionWaitSet.hpp"
 
 #include <is/systemhandle/SystemHandle.hpp>
 #include <is/utils/Log.hpp>
@@ -38,8 +40,9 @@ namespace sh {
 namespace fastdds {
 
 /**
- * @brief Forward declaration.
+ * @brief Forward declarations.
  */
+class ConversionContext;
 class Participant;
 
 /**
@@ -81,6 +84,9 @@ public:
      * @param[in] participant The associated *Integration Service* Participant, which holds the
      *            DDS entities that compose this Server.
      *
+     * @param[in] conversion The conversion context of the system, which keeps the
+     *            *Fast DDS* builders of its types.
+     *
      * @param[in] service_name The service name. It will produce two topics:
      *            `<service_name>_Request` and `<service_name>_Reply`.
      *
@@ -90,14 +96,22 @@ public:
      *
      * @param[in] config Additional configuration that might be required to configure this Server.
      *
+     * @param[in] waitset If not `nullptr`, the reply DataReader is created without listener and its
+     *            events are handled from the threads of this ReceptionWaitSet.
+     *
+     * @param[in] realtime Optional real-time settings, applied to the reception threads.
+     *
      * @throws DDSMiddlewareExeption if some error occurs while creating the *Fast DDS* entities.
      */
     Server(
             eprosima::is::sh::fastdds::Participant* participant,
+            ConversionContext* conversion,
             const std::string& service_name,
             const xtypes::DynamicType& request_type,
             const xtypes::DynamicType& reply_type,
-            const YAML::Node& config);
+            const YAML::Node& config,
+            ReceptionWaitSet* waitset = nullptr,
+            const RealTime* realtime = nullptr);
 
     // TODO(@jamoralp): use XML profile to create request publisher / reply subscriber?
 
@@ -191,6 +205,8 @@ private:
      * Class members.
      */
     Participant* participant_;
+    ReceptionWaitSet* waitset_;
+    const RealTime* realtime_;
     const std::string service_name_;
 
     struct RequestEntities
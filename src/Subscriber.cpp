@@ -26,7 +26,12 @@
 #if FASTRTPS_VERSION_MINOR >= 2
 #include <fastdds/dds/subscriber/InstanceState.hpp>
 #endif //  if FASTRTPS_VERSION_MINOR >= 2
+#if FASTRTPS_VERSION_MINOR >= 6
+#include <fastdds/dds/topic/ContentFilteredTopic.hpp>
+#endif //  if FASTRTPS_VERSION_MINOR >= 6
 
+#include <algorithm>
+#include <cmath>
 #include <functional>
 #include <iostream>
 
@@ -37,32 +42,192 @@ namespace fastdds {
 
 Subscriber::Subscriber(
         Participant* participant,
+        ConversionContext* conversion,
         const std::string& topic_name,
         const xtypes::DynamicType& message_type,
-        TopicSubscriberSystem::SubscriptionCallback* is_callback)
+        TopicSubscriberSystem::SubscriptionCallback* is_callback,
+        const YAML::Node& config,
+        OrderedExecutor* executor,
+        ReceptionWaitSet* waitset,
+        const RealTime* realtime)
     : participant_(participant)
+    , conversion_(conversion)
     , dds_subscriber_(nullptr)
-    , dynamic_data_(nullptr)
+    , dds_topic_(nullptr)
+    , dds_filtered_topic_(nullptr)
+    , dds_datareader_(nullptr)
+    , max_batch_samples_(1)
+    , min_separation_ns_(0)
+    , max_age_ns_(0)
+    , queued_samples_(0)
+    , queue_depth_(0)
+    , overflow_policy_(OverflowPolicy::BLOCK)
+    , conflate_(false)
+    , sequence_(0)
+    , stop_queue_(false)
+    , executor_(executor)
+    , waitset_(waitset)
+    , realtime_(realtime)
+    , topic_key_(std::hash<std::string>()(topic_name))
+    , pending_tasks_(0)
     , topic_name_(topic_name)
     , message_type_(message_type)
-    , is_callback_(is_callback)
+    , is_callbacks_{is_callback}
     , reception_threads_()
     , stop_cleaner_(false)
-    , cleaner_thread_(&Subscriber::cleaner_function, this)
     , logger_("is::sh::FastDDS::Subscriber")
 {
-    DynamicTypeBuilder* builder = Conversion::create_builder(message_type);
-    if (builder != nullptr)
+    if (config["batch"] && config["batch"]["max_samples"])
     {
-        participant->register_dynamic_type(topic_name, message_type.name(), builder);
+        max_batch_samples_ = config["batch"]["max_samples"].as<size_t>();
+        if (0 == max_batch_samples_)
+        {
+            throw DDSMiddlewareException(
+                      logger_, "Batch 'max_samples' for topic '" + topic_name + "' must be greater than 0");
+        }
+
+        logger_ << utils::Logger::Level::DEBUG
+                << "Subscriber for topic '" << topic_name << "' delivers batches of up to "
+                << max_batch_samples_ << " samples" << std::endl;
     }
-    else
+
+    if (config["queue"])
+    {
+        const YAML::Node& queue = config["queue"];
+        if (queue["depth"])
+        {
+            queue_depth_ = queue["depth"].as<size_t>();
+        }
+
+        const std::string overflow = queue["overflow"] ? queue["overflow"].as<std::string>() : "block";
+        if ("block" == overflow)
+        {
+            overflow_policy_ = OverflowPolicy::BLOCK;
+        }
+        else if ("drop_oldest" == overflow)
+        {
+            overflow_policy_ = OverflowPolicy::DROP_OLDEST;
+        }
+        else if ("drop_newest" == overflow)
+        {
+            overflow_policy_ = OverflowPolicy::DROP_NEWEST;
+        }
+        else if ("keep_latest" == overflow)
+        {
+            overflow_policy_ = OverflowPolicy::KEEP_LATEST;
+        }
+        else
+        {
+            throw DDSMiddlewareException(
+                      logger_, "Unknown queue overflow policy '" + overflow + "' for topic '" + topic_name
+                      + "'. Allowed values are 'block', 'drop_oldest', 'drop_newest' and 'keep_latest'");
+        }
+
+        if (queue["conflate"])
+        {
+            conflate_ = queue["conflate"].as<bool>();
+        }
+
+        logger_ << utils::Logger::Level::DEBUG
+                << "Subscriber for topic '" << topic_name << "' queues up to " << queue_depth_
+                << " samples, with overflow policy '" << overflow << "'"
+                << (conflate_ ? " and conflation of pending samples" : "") << std::endl;
+    }
+
+    if (config["filter"])
+    {
+        const YAML::Node& filter = config["filter"];
+        std::vector<std::string> parameters;
+        if (filter.IsMap() && filter["parameters"])
+        {
+            parameters = filter["parameters"].as<std::vector<std::string> >();
+        }
+
+        if (filter.IsMap() && !filter["expression"])
+        {
+            throw DDSMiddlewareException(
+                      logger_, "Filter for topic '" + topic_name + "' must have an 'expression' key");
+        }
+
+        filter_.reset(new ContentFilter(
+                    filter.IsMap() ? filter["expression"].as<std::string>() : filter.as<std::string>(),
+                    parameters));
+
+        for (const ContentFilter::Path& path : filter_->fields())
+        {
+            if (!Conversion::is_filterable_member(message_type, path))
+            {
+                std::string field;
+                for (const std::string& member : path)
+                {
+                    field += (field.empty() ? "" : ".") + member;
+                }
+
+                throw DDSMiddlewareException(
+                          logger_, "Filter for topic '" + topic_name + "' uses field '" + field
+                          + "', which is not a primitive, string or enumeration member of type '"
+                          + message_type.name() + "'");
+            }
+
+            // Enumerators may be compared by name
+            ContentFilter::Enumerators enumerators;
+            if (Conversion::get_enumerators(message_type, path, enumerators))
+            {
+                filter_->set_enumerators(path, enumerators);
+            }
+        }
+
+        // Subscribers are shared by topic and reader options, so the name must tell apart every
+        // reader configuration of the topic, not only its filter
+        filtered_topic_name_ = topic_name + "_is_filtered_"
+                + std::to_string(std::hash<std::string>()(YAML::Dump(config)));
+    }
+
+    if (config["min_separation"] && config["max_rate"])
     {
         throw DDSMiddlewareException(
-                  logger_, "Cannot create builder for type " + message_type.name());
+                  logger_, "Topic '" + topic_name + "' cannot set both 'min_separation' and 'max_rate'");
     }
+    else if (config["min_separation"] || config["max_rate"])
+    {
+        const double min_separation = config["min_separation"]
+                ? config["min_separation"].as<double>()
+                : 1.0 / config["max_rate"].as<double>();
 
-    dynamic_data_ = participant->create_dynamic_data(topic_name);
+        if (!(0 <= min_separation) || std::isinf(min_separation))
+        {
+            throw DDSMiddlewareException(
+                      logger_, "Topic '" + topic_name + "' has an invalid 'min_separation' or 'max_rate'");
+        }
+
+        min_separation_ns_ = static_cast<int64_t>(min_separation * 1e9);
+
+        logger_ << utils::Logger::Level::DEBUG
+                << "Subscriber for topic '" << topic_name << "' delivers one sample per instance every "
+                << min_separation << " seconds at most" << std::endl;
+    }
+
+    if (config["fields"])
+    {
+        projection_ = Conversion::create_projection(
+            message_type, config["fields"].as<std::vector<std::string> >());
+    }
+
+    if (config["max_age"])
+    {
+        const double max_age = config["max_age"].as<double>();
+        if (!(0 < max_age) || std::isinf(max_age))
+        {
+            throw DDSMiddlewareException(
+                      logger_, "Topic '" + topic_name + "' has an invalid 'max_age'");
+        }
+
+        max_age_ns_ = static_cast<int64_t>(max_age * 1e9);
+
+        logger_ << utils::Logger::Level::DEBUG
+                << "Subscriber for topic '" << topic_name << "' discards samples older than "
+                << max_age << " seconds" << std::endl;
+    }
 
     // Retrieve DDS participant
     ::fastdds::dds::DomainParticipant* dds_participant = participant->get_dds_participant();
@@ -71,83 +236,227 @@ Subscriber::Subscriber(
         throw DDSMiddlewareException(
                   logger_, "Trying to create a subscriber without a DDS participant!");
     }
+    participant_prefix_ = dds_participant->guid().guidPrefix;
+
+    // Get the DDS subscriber shared by the topics in the configured partitions
+    dds_subscriber_ = participant->get_dds_subscriber(participant->get_partition_qos(config["partitions"]));
+    if (!dds_subscriber_)
+    {
+        std::ostringstream err;
+        err << "Fast DDS subscriber for topic '" << topic_name << "' was not created";
+
+        throw DDSMiddlewareException(logger_, err.str());
+    }
+
+    // DDS datareader QoS
+    datareader_qos_ = ::fastdds::dds::DATAREADER_QOS_DEFAULT;
+    ::fastdds::dds::ReliabilityQosPolicy rel_policy;
+    rel_policy.kind = ::fastdds::dds::RELIABLE_RELIABILITY_QOS;
+    datareader_qos_.reliability(rel_policy);
+
+    if (0 < max_age_ns_)
+    {
+        // Expired samples are removed from the DataReader history as well
+        datareader_qos_.lifespan().duration =
+                fastrtps::Duration_t(static_cast<long double>(max_age_ns_) / 1e9L);
+    }
+
+    if (0 < min_separation_ns_)
+    {
+        // Fast DDS does not enforce it yet: the samples are downsampled in on_data_available as well
+        datareader_qos_.time_based_filter().minimum_separation =
+                fastrtps::Duration_t(static_cast<long double>(min_separation_ns_) / 1e9L);
+    }
+
+    if (config["data_sharing"])
+    {
+        const std::string data_sharing = config["data_sharing"].as<std::string>();
+#if FASTRTPS_VERSION_MINOR >= 2
+        if ("auto" == data_sharing)
+        {
+            datareader_qos_.data_sharing().automatic();
+        }
+        else if ("on" == data_sharing)
+        {
+            if (!Conversion::is_bounded(message_type))
+            {
+                throw DDSMiddlewareException(
+                          logger_, "Data-sharing cannot be enabled for topic '" + topic_name
+                          + "', as its type '" + message_type.name() + "' has unbounded members");
+            }
+            datareader_qos_.data_sharing().on("");
+        }
+        else if ("off" == data_sharing)
+        {
+            datareader_qos_.data_sharing().off();
+        }
+        else
+        {
+            throw DDSMiddlewareException(
+                      logger_, "Unknown data_sharing mode '" + data_sharing + "' for topic '" + topic_name
+                      + "'. Allowed values are 'auto', 'on' and 'off'");
+        }
 
-    // Create DDS subscriber with default subscriber QoS
-    dds_subscriber_ = dds_participant->create_subscriber(::fastdds::dds::SUBSCRIBER_QOS_DEFAULT);
+        logger_ << utils::Logger::Level::DEBUG
+                << "Subscriber for topic '" << topic_name << "' uses data-sharing mode '"
+                << data_sharing << "'" << std::endl;
+#else
+        logger_ << utils::Logger::Level::WARN
+                << "Data-sharing requires Fast DDS v2.2.0 or newer, ignoring data_sharing mode '"
+                << data_sharing << "' for topic '" << topic_name << "'" << std::endl;
+#endif //  if FASTRTPS_VERSION_MINOR >= 2
+    }
 
-    if (dds_subscriber_)
+    if (config["lazy"] && config["lazy"].as<bool>())
     {
+        participant->add_lazy_endpoint(topic_name, false, this, [this]()
+                {
+                    create_datareader();
+                });
+
         logger_ << utils::Logger::Level::DEBUG
-                << "Created Fast DDS subscriber for topic '" << topic_name << "'" << std::endl;
+                << "Fast DDS datareader for topic '" << topic_name
+                << "' will be created when a remote publisher is discovered" << std::endl;
+    }
+    else
+    {
+        participant->create_endpoint(this, [this]()
+                {
+                    create_datareader();
+                });
+    }
+}
+
+void Subscriber::create_datareader()
+{
+    DynamicTypeBuilder* builder = conversion_->create_builder(message_type_);
+    if (builder != nullptr)
+    {
+        participant_->register_dynamic_type(
+            topic_name_, message_type_.name(), builder, Conversion::is_bounded(message_type_));
     }
     else
+    {
+        throw DDSMiddlewareException(
+                  logger_, "Cannot create builder for type " + message_type_.name());
+    }
+
+    // Make sure that the topic type is known before filling the pool
+    release_data(acquire_data());
+
+    if (nullptr != realtime_)
+    {
+        // Allocate up front, so that no allocation happens in the reception path
+        for (size_t i = 1; i < realtime_->pool_samples(); ++i)
+        {
+            data_pool_.push_back(participant_->create_dynamic_data(topic_name_));
+        }
+    }
+
+    // Create DDS topic
+    dds_topic_ = participant_->get_dds_topic(topic_name_, message_type_.name());
+    if (!dds_topic_)
     {
         std::ostringstream err;
-        err << "Fast DDS subscriber for topic '" << topic_name << "' was not created";
+        err << "Fast DDS topic '" << topic_name_ << "' with type '"
+            << message_type_.name() << "' was not created";
 
         throw DDSMiddlewareException(logger_, err.str());
     }
 
-    // Create DDS topic
-    auto topic_description = dds_participant->lookup_topicdescription(topic_name);
-    if (!topic_description)
+    ::fastdds::dds::TopicDescription* reader_topic = dds_topic_;
+    if (filter_)
     {
-        dds_topic_ = dds_participant->create_topic(
-            topic_name, message_type.name(), ::fastdds::dds::TOPIC_QOS_DEFAULT);
-        if (dds_topic_)
+#if FASTRTPS_VERSION_MINOR >= 6
+        // Filtered by Fast DDS, on the writer side when the remote writer supports it
+        dds_filtered_topic_ = participant_->get_dds_participant()->create_contentfilteredtopic(
+            filtered_topic_name_, dds_topic_, filter_->expression(), filter_->parameters());
+#endif //  if FASTRTPS_VERSION_MINOR >= 6
+
+        if (dds_filtered_topic_)
         {
             logger_ << utils::Logger::Level::DEBUG
-                    << "Created Fast DDS topic '" << topic_name << "' with type '"
-                    << message_type.name() << "'" << std::endl;
+                    << "Created Fast DDS content filtered topic for topic '" << topic_name_
+                    << "' with filter '" << filter_->expression() << "'" << std::endl;
+
+            reader_topic = dds_filtered_topic_;
+            filter_.reset();
         }
         else
         {
-            std::ostringstream err;
-            err << "Fast DDS topic '" << topic_name << "' with type '"
-                << message_type.name() << "' was not created";
-
-            throw DDSMiddlewareException(logger_, err.str());
+            logger_ << utils::Logger::Level::WARN
+                    << "Fast DDS cannot filter topic '" << topic_name_ << "', the filter '"
+                    << filter_->expression() << "' will be evaluated before converting each sample"
+                    << std::endl;
         }
     }
-    else
-    {
-        dds_topic_ = static_cast<::fastdds::dds::Topic*>(topic_description);
-    }
 
-    // Create DDS datareader
-    ::fastdds::dds::DataReaderQos datareader_qos = ::fastdds::dds::DATAREADER_QOS_DEFAULT;
-    ::fastdds::dds::ReliabilityQosPolicy rel_policy;
-    rel_policy.kind = ::fastdds::dds::RELIABLE_RELIABILITY_QOS;
-    datareader_qos.reliability(rel_policy);
+    // Endpoints announced through static discovery are identified by their user defined ID
+    datareader_qos_.endpoint().user_defined_id =
+            participant_->add_static_reader(dds_topic_, dds_subscriber_, datareader_qos_);
 
-    dds_datareader_ = dds_subscriber_->create_datareader(dds_topic_, datareader_qos, this);
+    // When a WaitSet drives the reception, the listener is not set
+    dds_datareader_ = dds_subscriber_->create_datareader(
+        reader_topic, datareader_qos_, nullptr == waitset_ ? this : nullptr);
     if (dds_datareader_)
     {
         logger_ << utils::Logger::Level::DEBUG
-                << "Created Fast DDS datareader for topic '" << topic_name << "'" << std::endl;
+                << "Created Fast DDS datareader for topic '" << topic_name_ << "'" << std::endl;
 
         participant_->associate_topic_to_dds_entity(dds_topic_, dds_datareader_);
+
+        if (nullptr != waitset_)
+        {
+            waitset_->attach(dds_datareader_, this);
+        }
     }
     else
     {
         std::ostringstream err;
-        err << "Fast DDS datareader for topic '" << topic_name << "' was not created";
+        err << "Fast DDS datareader for topic '" << topic_name_ << "' was not created";
 
         throw DDSMiddlewareException(logger_, err.str());
     }
+
+    cleaner_thread_ = std::thread(&Subscriber::cleaner_function, this);
 }
 
 Subscriber::~Subscriber()
 {
+    participant_->cancel_lazy_endpoint(this);
+
     logger_ << utils::Logger::Level::INFO
             << "Waiting for current processing messages before quitting" << std::endl;
 
+    {
+        // Release the listener, in case it is blocked waiting for room in the queue
+        std::unique_lock<std::mutex> lock(queue_mtx_);
+        stop_queue_ = true;
+        queue_cv_.notify_all();
+    }
+
+    if (nullptr != waitset_ && nullptr != dds_datareader_)
+    {
+        waitset_->detach(dds_datareader_);
+    }
+
     {
         std::unique_lock<std::mutex> lock(cleaner_mtx_);
         stop_cleaner_ = true;
         cleaner_cv_.notify_one();
     }
 
+    {
+        // Wait for the tasks handed over to the executor
+        std::unique_lock<std::mutex> lock(pending_mtx_);
+        pending_cv_.wait(
+            lock,
+            [this]()
+            {
+                return 0 == pending_tasks_;
+            });
+    }
+
     if (cleaner_thread_.joinable())
     {
         cleaner_thread_.join();
@@ -156,14 +465,46 @@ Subscriber::~Subscriber()
     logger_ << utils::Logger::Level::INFO
             << "All messages were processed. Quitting now..." << std::endl;
 
+    log_statistics();
+
     std::unique_lock<std::mutex> lock(data_mtx_);
-    participant_->delete_dynamic_data(dynamic_data_);
+    for (auto& pair : queue_)
+    {
+        for (Sample& sample : pair.second)
+        {
+            data_pool_.push_back(sample.data);
+        }
+    }
+    queue_.clear();
+
+    for (fastrtps::types::DynamicData* data : data_pool_)
+    {
+        participant_->delete_dynamic_data(data);
+    }
+    data_pool_.clear();
+
+    if (nullptr == dds_topic_)
+    {
+        // Deferred, and never created
+        return;
+    }
 
+    // The creation of the DataReader may have failed after creating the topics
     bool delete_topic = participant_->dissociate_topic_from_dds_entity(dds_topic_, dds_datareader_);
 
-    dds_datareader_->set_listener(nullptr);
-    dds_subscriber_->delete_datareader(dds_datareader_);
-    participant_->get_dds_participant()->delete_subscriber(dds_subscriber_);
+    if (nullptr != dds_datareader_)
+    {
+        dds_datareader_->set_listener(nullptr);
+        dds_subscriber_->delete_datareader(dds_datareader_);
+    }
+
+#if FASTRTPS_VERSION_MINOR >= 6
+    if (dds_filtered_topic_)
+    {
+        participant_->get_dds_participant()->delete_contentfilteredtopic(
+            static_cast<::fastdds::dds::ContentFilteredTopic*>(dds_filtered_topic_));
+    }
+#endif //  if FASTRTPS_VERSION_MINOR >= 6
 
     if (delete_topic)
     {
@@ -171,70 +512,492 @@ Subscriber::~Subscriber()
     }
 }
 
-void Subscriber::receive(
-        const fastrtps::types::DynamicData* dds_message,
-        ::fastdds::dds::SampleInfo sample_info)
+void Subscriber::add_callback(
+        TopicSubscriberSystem::SubscriptionCallback* is_callback)
 {
-    logger_ << utils::Logger::Level::INFO
-            << "Receiving message from DDS for topic '" << topic_name_ << "'" << std::endl;
+    std::unique_lock<std::mutex> lock(callbacks_mtx_);
+    is_callbacks_.push_back(is_callback);
 
-    ::xtypes::DynamicData is_message(message_type_);
-    bool success = Conversion::fastdds_to_xtypes(dds_message, is_message);
-    data_mtx_.unlock();
+    logger_ << utils::Logger::Level::DEBUG
+            << "Attached callback number " << is_callbacks_.size()
+            << " to subscriber for topic '" << topic_name_ << "'" << std::endl;
+}
 
-    if (success)
-    {
-        logger_ << utils::Logger::Level::INFO
-                << "Received message: [[ " << is_message << " ]]" << std::endl;
+const std::string& Subscriber::topic_name() const
+{
+    return topic_name_;
+}
 
-        (*is_callback_)(is_message, static_cast<void*>(&sample_info));
-    }
-    else
+const xtypes::DynamicType& Subscriber::message_type() const
+{
+    return message_type_;
+}
+
+Subscriber::Statistics Subscriber::statistics() const
+{
+    std::unique_lock<std::mutex> lock(queue_mtx_);
+    return statistics_;
+}
+
+void Subscriber::log_statistics()
+{
+    Statistics stats = statistics();
+
+    logger_ << utils::Logger::Level::INFO
+            << "Reception statistics for topic '" << topic_name_ << "': received " << stats.received
+            << ", dropped oldest " << stats.dropped_oldest << ", dropped newest " << stats.dropped_newest
+            << ", replaced " << stats.replaced << ", conflated " << stats.conflated
+            << ", blocked " << stats.blocked << ", internal " << stats.internal
+            << ", expired " << stats.expired << ", filtered " << stats.filtered
+            << ", downsampled " << stats.downsampled << std::endl;
+}
+
+void Subscriber::receive(
+        OrderedExecutor::Key key)
+{
+    if (nullptr != realtime_)
     {
-        logger_ << utils::Logger::Level::ERROR
-                << "Failed to convert message from DDS to Integration Service for topic '"
-                << topic_name_ << "'" << std::endl;
+        realtime_->configure_current_thread();
     }
 
+    std::vector<Sample> samples = dequeue(key);
+    process(samples);
+
     // Notify that we have ended
     std::unique_lock<std::mutex> lock(cleaner_mtx_);
     finished_threads_.push_back(std::this_thread::get_id());
     cleaner_cv_.notify_one();
 }
 
-void Subscriber::on_data_available(
-        ::fastdds::dds::DataReader* /*reader*/)
+void Subscriber::process(
+        std::vector<Sample>& samples)
+{
+    std::vector<::xtypes::DynamicData> messages;
+    std::vector<::fastdds::dds::SampleInfo> infos;
+    messages.reserve(samples.size());
+    infos.reserve(samples.size());
+
+    uint64_t expired = 0;
+
+    for (Sample& sample : samples)
+    {
+        // Samples may have waited in the queue for too long, or while converting the previous ones
+        if (0 < max_age_ns_ && is_expired(sample.info, current_time_ns()))
+        {
+            ++expired;
+            release_data(sample.data);
+            continue;
+        }
+
+        logger_ << utils::Logger::Level::INFO
+                << "Receiving message from DDS for topic '" << topic_name_ << "'" << std::endl;
+
+        ::xtypes::DynamicData is_message(message_type_);
+        bool success = Conversion::fastdds_to_xtypes(sample.data, is_message, projection_.get());
+        release_data(sample.data);
+
+        if (success)
+        {
+            logger_ << utils::Logger::Level::INFO
+                    << "Received message: [[ " << is_message << " ]]" << std::endl;
+
+            messages.emplace_back(std::move(is_message));
+            infos.push_back(sample.info);
+        }
+        else
+        {
+            logger_ << utils::Logger::Level::ERROR
+                    << "Failed to convert message from DDS to Integration Service for topic '"
+                    << topic_name_ << "'" << std::endl;
+        }
+    }
+
+    if (0 < expired)
+    {
+        std::unique_lock<std::mutex> lock(queue_mtx_);
+        statistics_.expired += expired;
+    }
+
+    if (!messages.empty())
+    {
+        deliver(messages, infos);
+    }
+}
+
+void Subscriber::deliver(
+        const std::vector<::xtypes::DynamicData>& messages,
+        std::vector<::fastdds::dds::SampleInfo>& infos)
+{
+    // Converted once, shared read-only by every attached callback.
+    std::vector<TopicSubscriberSystem::SubscriptionCallback*> callbacks;
+    {
+        std::unique_lock<std::mutex> lock(callbacks_mtx_);
+        callbacks = is_callbacks_;
+    }
+
+    for (TopicSubscriberSystem::SubscriptionCallback* is_callback : callbacks)
+    {
+        for (size_t i = 0; i < messages.size(); ++i)
+        {
+            (*is_callback)(messages[i], static_cast<void*>(&infos[i]));
+        }
+    }
+}
+
+void Subscriber::dispatch(
+        OrderedExecutor::Key key)
+{
+    if (nullptr == executor_)
+    {
+        std::thread* thread = new std::thread(&Subscriber::receive, this, key);
+        reception_threads_.emplace(thread->get_id(), thread);
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(pending_mtx_);
+        ++pending_tasks_;
+    }
+
+    executor_->submit(
+        key,
+        [this, key]()
+        {
+            std::vector<Sample> samples = dequeue(key);
+            process(samples);
+
+            std::unique_lock<std::mutex> lock(pending_mtx_);
+            if (0 == --pending_tasks_)
+            {
+                pending_cv_.notify_all();
+            }
+        });
+}
+
+bool Subscriber::enqueue(
+        Sample& sample,
+        const std::function<void()>& before_blocking)
+{
+    std::unique_lock<std::mutex> lock(queue_mtx_);
+
+    ++statistics_.received;
+    sample.sequence = sequence_++;
+
+    if (conflate_ && replace_latest(sample))
+    {
+        ++statistics_.conflated;
+
+        lock.unlock();
+        release_data(sample.data);
+        return false;
+    }
+
+    if (0 != queue_depth_ && queue_depth_ <= queued_samples_)
+    {
+        switch (overflow_policy_)
+        {
+            case OverflowPolicy::BLOCK:
+            {
+                ++statistics_.blocked;
+
+                lock.unlock();
+                before_blocking();
+                lock.lock();
+
+                queue_cv_.wait(
+                    lock,
+                    [this]()
+                    {
+                        return stop_queue_ || queued_samples_ < queue_depth_;
+                    });
+
+                if (stop_queue_)
+                {
+                    lock.unlock();
+                    release_data(sample.data);
+                    return false;
+                }
+                break;
+            }
+            case OverflowPolicy::DROP_NEWEST:
+            {
+                ++statistics_.dropped_newest;
+
+                lock.unlock();
+                release_data(sample.data);
+                return false;
+            }
+            case OverflowPolicy::KEEP_LATEST:
+            {
+                if (replace_latest(sample))
+                {
+                    ++statistics_.replaced;
+
+                    lock.unlock();
+                    release_data(sample.data);
+                    return false;
+                }
+
+                // Not any sample of this instance is queued, make room as with DROP_OLDEST
+                [[fallthrough]];
+            }
+            case OverflowPolicy::DROP_OLDEST:
+            {
+                auto oldest = queue_.begin();
+                for (auto it = queue_.begin(); it != queue_.end(); ++it)
+                {
+                    if (it->second.front().sequence < oldest->second.front().sequence)
+                    {
+                        oldest = it;
+                    }
+                }
+
+                ++statistics_.dropped_oldest;
+
+                fastrtps::types::DynamicData* dropped = oldest->second.front().data;
+                oldest->second.pop_front();
+                if (oldest->second.empty())
+                {
+                    queue_.erase(oldest);
+                }
+                --queued_samples_;
+
+                release_data(dropped);
+                break;
+            }
+        }
+    }
+
+    queue_[sample.key].push_back(sample);
+    ++queued_samples_;
+
+    return true;
+}
+
+bool Subscriber::replace_latest(
+        Sample& sample)
+{
+    auto it = queue_.find(sample.key);
+    if (queue_.end() == it || it->second.back().info.instance_handle != sample.info.instance_handle)
+    {
+        return false;
+    }
+
+    // Overwrite the newest queued sample of the instance, which keeps its place
+    std::swap(it->second.back().data, sample.data);
+    it->second.back().info = sample.info;
+    return true;
+}
+
+std::vector<Subscriber::Sample> Subscriber::dequeue(
+        OrderedExecutor::Key key)
+{
+    std::vector<Sample> samples;
+
+    std::unique_lock<std::mutex> lock(queue_mtx_);
+
+    auto it = queue_.find(key);
+    if (queue_.end() == it)
+    {
+        // Already processed by a previous batch, or dropped
+        return samples;
+    }
+
+    std::deque<Sample>& pending = it->second;
+    size_t count = std::min(max_batch_samples_, pending.size());
+    samples.assign(pending.begin(), pending.begin() + count);
+    pending.erase(pending.begin(), pending.begin() + count);
+
+    if (pending.empty())
+    {
+        queue_.erase(it);
+    }
+    queued_samples_ -= count;
+
+    lock.unlock();
+    queue_cv_.notify_all();
+
+    return samples;
+}
+
+int64_t Subscriber::current_time_ns()
+{
+    fastrtps::rtps::Time_t now;
+    fastrtps::rtps::Time_t::now(now);
+    return now.to_ns();
+}
+
+bool Subscriber::is_expired(
+        const ::fastdds::dds::SampleInfo& info,
+        int64_t now_ns) const
+{
+    return 0 < max_age_ns_ && now_ns - info.source_timestamp.to_ns() > max_age_ns_;
+}
+
+OrderedExecutor::Key Subscriber::dispatch_key(
+        const ::fastdds::dds::SampleInfo& info) const
+{
+    OrderedExecutor::Key key = topic_key_;
+    for (fastrtps::rtps::octet byte : info.instance_handle.value)
+    {
+        key = key * 31 + byte;
+    }
+    return key;
+}
+
+fastrtps::types::DynamicData* Subscriber::acquire_data()
+{
+    {
+        std::unique_lock<std::mutex> lock(data_mtx_);
+        if (!data_pool_.empty())
+        {
+            fastrtps::types::DynamicData* data = data_pool_.back();
+            data_pool_.pop_back();
+            return data;
+        }
+    }
+
+    return participant_->create_dynamic_data(topic_name_);
+}
+
+void Subscriber::release_data(
+        fastrtps::types::DynamicData* data)
 {
-    using namespace std::placeholders;
+    std::unique_lock<std::mutex> lock(data_mtx_);
+    data_pool_.push_back(data);
+}
 
-    ::fastdds::dds::SampleInfo info;
+void Subscriber::on_data_available(
+        ::fastdds::dds::DataReader* reader)
+{
     std::unique_lock<std::mutex> lock(cleaner_mtx_);
-    data_mtx_.lock();
 
-    if (!stop_cleaner_ && fastrtps::types::ReturnCode_t::RETCODE_OK
-            == dds_datareader_->take_next_sample(dynamic_data_, &info))
+    if (stop_cleaner_)
     {
+        return;
+    }
+
+    // Take every sample available in this activation. A batch is dispatched whenever
+    // `max_samples` new samples of the same instance are queued.
+    std::vector<std::pair<OrderedExecutor::Key, size_t> > undispatched;
+    uint64_t internal = 0;
+    uint64_t expired = 0;
+    uint64_t filtered = 0;
+    uint64_t downsampled = 0;
+
+    auto flush = [this, &undispatched]()
+            {
+                for (const auto& pair : undispatched)
+                {
+                    if (0 < pair.second)
+                    {
+                        dispatch(pair.first);
+                    }
+                }
+                undispatched.clear();
+            };
+
+    while (true)
+    {
+        Sample sample{acquire_data(), ::fastdds::dds::SampleInfo(), 0, 0};
+
+        // Taken from the notifying reader, as it may notify before create_datareader() stores it
+        if (fastrtps::types::ReturnCode_t::RETCODE_OK
+                != reader->take_next_sample(sample.data, &sample.info))
+        {
+            release_data(sample.data);
+            break;
+        }
+
 #if FASTRTPS_VERSION_MINOR < 2
-        if (::fastdds::dds::InstanceStateKind::ALIVE == info.instance_state)
+        if (::fastdds::dds::InstanceStateKind::ALIVE != sample.info.instance_state)
 #else
-        if (::fastdds::dds::InstanceStateKind::ALIVE_INSTANCE_STATE == info.instance_state)
+        if (::fastdds::dds::InstanceStateKind::ALIVE_INSTANCE_STATE != sample.info.instance_state)
 #endif //  if FASTRTPS_VERSION_MINOR < 2
         {
-            logger_ << utils::Logger::Level::DEBUG
-                    << "Processing incoming data available for topic '"
-                    << topic_name_ << "'" << std::endl;
+            // The instance is gone, forget about it
+            last_accepted_ns_.erase(dispatch_key(sample.info));
 
-            std::thread* thread = new std::thread(&Subscriber::receive, this, dynamic_data_, info);
-            reception_threads_.emplace(thread->get_id(), thread);
+            release_data(sample.data);
+            continue;
         }
-        else
+
+        // Samples published by the Integration Service itself would be discarded after conversion
+        if (fastrtps::rtps::iHandle2GUID(sample.info.publication_handle).guidPrefix == participant_prefix_)
+        {
+            ++internal;
+            release_data(sample.data);
+            continue;
+        }
+
+        // Read for every sample, as a blocking queue may have kept this thread waiting
+        if (0 < max_age_ns_ && is_expired(sample.info, current_time_ns()))
+        {
+            ++expired;
+            release_data(sample.data);
+            continue;
+        }
+
+        if (filter_ && !filter_->evaluate(
+                    [&sample](const ContentFilter::Path& path, ContentFilter::Value& value)
+                    {
+                        return Conversion::fastdds_member_value(sample.data, path, value);
+                    }))
+        {
+            ++filtered;
+            release_data(sample.data);
+            continue;
+        }
+
+        sample.key = dispatch_key(sample.info);
+
+        if (0 < min_separation_ns_)
         {
-            data_mtx_.unlock();
+            const int64_t timestamp = sample.info.source_timestamp.to_ns();
+            auto last = last_accepted_ns_.find(sample.key);
+            if (last_accepted_ns_.end() != last
+                    && timestamp >= last->second && timestamp - last->second < min_separation_ns_)
+            {
+                ++downsampled;
+                release_data(sample.data);
+                continue;
+            }
+            last_accepted_ns_[sample.key] = timestamp;
+        }
+
+        if (!enqueue(sample, flush))
+        {
+            continue;
+        }
+
+        auto it = std::find_if(undispatched.begin(), undispatched.end(),
+                        [&sample](const std::pair<OrderedExecutor::Key, size_t>& pair)
+                        {
+                            return sample.key == pair.first;
+                        });
+
+        if (undispatched.end() == it)
+        {
+            undispatched.emplace_back(sample.key, 0);
+            it = undispatched.end() - 1;
+        }
+
+        if (max_batch_samples_ == ++it->second)
+        {
+            dispatch(sample.key);
+            it->second = 0;
         }
     }
-    else
+
+    flush();
+
+    if (0 < internal || 0 < expired || 0 < filtered || 0 < downsampled)
     {
-        data_mtx_.unlock();
+        std::unique_lock<std::mutex> queue_lock(queue_mtx_);
+        statistics_.internal += internal;
+        statistics_.expired += expired;
+        statistics_.filtered += filtered;
+        statistics_.downsampled += downsampled;
     }
 }
 
@@ -18,17 +18,28 @@
 #ifndef _IS_SH_FASTDDS__INTERNAL__SUBSCRIBER_HPP_
 #define _IS_SH_FASTDDS__INTERNAL__SUBSCRIBER_HPP_
 
+#include "ContentFilter.hpp"
 #include "DDSMiddlewareException.hpp"
+#include "OrderedExecutor.hpp"
 #include "Participant.hpp"
+#include "RealTime.hpp"
+#include "ReceptionWaitSet.hpp"
 
 #include <is/systemhandle/SystemHandle.hpp>
 #include <is/utils/Log.hpp>
 
 #include <fastdds/dds/subscriber/Subscriber.hpp>
 #include <fastdds/dds/subscriber/SampleInfo.hpp>
+#include <fastdds/dds/subscriber/qos/DataReaderQos.hpp>
 
 #include <thread>
 #include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace fastdds = eprosima::fastdds;
 
@@ -37,11 +48,21 @@ namespace is {
 namespace sh {
 namespace fastdds {
 
+/**
+ * @brief Forward declaration.
+ */
+class ConversionContext;
+
 /**
  * @brief Forward declaration.
  */
 class Participant;
 
+/**
+ * @brief Forward declaration.
+ */
+struct Projection;
+
 /**
  * @class Subscriber
  *        This class represents a <a href="https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/subscriber/subscriber.html">
@@ -67,20 +88,70 @@ public:
      * @param[in] participant The associated *Integration Service* Participant,
      *            which holds this Subscriber.
      *
+     * @param[in] conversion The conversion context of the system, which keeps the
+     *            *Fast DDS* builders of its types.
+     *
      * @param[in] topic_name The topic that this DDS subscriber will attach to.
      *
      * @param[in] message_type A dynamic type definition of the topic's type.
      *
      * @param[in] is_callback Callback function signature defined by the *Integration Service*,
      *            triggered each time a new data arrives to the DDS Subscriber.
+     *            More callbacks can be attached later on by means of Subscriber::add_callback.
+     *
+     * @param[in] config Specific configuration regarding this subscriber, in *YAML* format.
+     *            Allowed fields are:
+     *            - `batch`: Map with a `max_samples` key. All the samples taken from the DataReader
+     *              in a single listener activation are converted and delivered to the
+     *              *Integration Service* by the same reception thread, in groups of up to
+     *              `max_samples` samples. Defaults to `1`, that is, one thread per sample.
+     *            - `queue`: Map with `depth` and `overflow` keys. Bounds the number of samples
+     *              taken from the DataReader and still waiting to be converted. When the queue
+     *              is full, the `overflow` policy decides what happens with a new sample:
+     *              `block` (default) stops the listener until there is room, `drop_oldest`
+     *              discards the oldest queued sample, `drop_newest` discards the new one and
+     *              `keep_latest` replaces the newest queued sample of the same instance.
+     *              Defaults to an unbounded queue. If `conflate` is `true`, a new sample
+     *              replaces the queued sample of the same instance still waiting to be
+     *              converted, if any, whether the queue is full or not.
+     *            - `filter`: DDS SQL-like filter expression, or map with `expression` and
+     *              `parameters` keys. Applied through a *Fast DDS* ContentFilteredTopic when
+     *              supported, or else evaluated on each sample before its conversion.
+     *            - `min_separation`: Minimum time, in seconds, between two delivered samples of
+     *              the same instance. Later samples are discarded before their conversion.
+     *            - `max_rate`: Alternative to `min_separation`, as the maximum number of samples
+     *              per second delivered for each instance.
+     *            - `fields`: List of members, as paths with dots through nested structures,
+     *              converted from the DDS samples. The rest keep their default value.
+     *            - `max_age`: Maximum age, in seconds, of a sample according to its source
+     *              timestamp. Older samples are discarded right after being taken and right
+     *              before being converted; and removed from the DataReader history.
+     *            - `lazy`: Defer the creation of the DataReader, and of its reception buffers and
+     *              threads, until a remote publisher of the topic is discovered.
+     *
+     * @param[in] executor Shared pool in charge of converting and delivering the incoming samples,
+     *            keeping them ordered per topic instance. If `nullptr`, a new reception thread
+     *            is launched for each batch of samples.
+     *
+     * @param[in] waitset If not `nullptr`, the DataReader is created without listener and its
+     *            events are handled from the threads of this ReceptionWaitSet instead of
+     *            from the *Fast DDS* receive threads.
+     *
+     * @param[in] realtime Optional real-time settings, applied to the reception threads.
+     *            Its `pool_samples` DynamicData are preallocated on construction.
      *
      * @throws DDSMiddlewareException if some error occurs while creating the *Fast DDS* subscriber.
      */
     Subscriber(
             Participant* participant,
+            ConversionContext* conversion,
             const std::string& topic_name,
             const xtypes::DynamicType& message_type,
-            TopicSubscriberSystem::SubscriptionCallback* is_callback);
+            TopicSubscriberSystem::SubscriptionCallback* is_callback,
+            const YAML::Node& config,
+            OrderedExecutor* executor = nullptr,
+            ReceptionWaitSet* waitset = nullptr,
+            const RealTime* realtime = nullptr);
 
     // TODO(@jamoralp): Create subscriber based on XML profiles?
 
@@ -114,18 +185,217 @@ public:
             Subscriber&& /*rhs*/) = delete;
 
     /**
-     * @brief Handle the receiving of a new message from the DDS dataspace.
+     * @brief Attach an additional *Integration Service* callback to this Subscriber.
      *
-     * @param[in] dds_message The incoming message.
+     * @details Several routes may subscribe to the same DDS topic. Instead of creating
+     *          a new DataReader for each of them, all of them share this Subscriber:
+     *          each incoming sample is converted only once and then handed to every
+     *          attached callback.
      *
-     * @param[in] sample_info Structure containing the relevant information regarding the incoming message.
+     * @param[in] is_callback The callback to be triggered for each incoming message.
      */
-    void receive(
-            const fastrtps::types::DynamicData* dds_message,
-            ::fastdds::dds::SampleInfo sample_info);
+    void add_callback(
+            TopicSubscriberSystem::SubscriptionCallback* is_callback);
+
+    /**
+     * @brief Get the topic name this subscriber is attached to.
+     *
+     * @returns The topic name.
+     */
+    const std::string& topic_name() const;
+
+    /**
+     * @brief Get the *xTypes* definition of the topic's type.
+     *
+     * @returns A const reference to the message type.
+     */
+    const xtypes::DynamicType& message_type() const;
+
+    /**
+     * @brief Counters of the samples discarded before conversion, and of the decisions
+     *        taken by the reception queue.
+     */
+    struct Statistics
+    {
+        uint64_t received = 0;
+        uint64_t dropped_oldest = 0;
+        uint64_t dropped_newest = 0;
+        uint64_t replaced = 0;
+        uint64_t conflated = 0;
+        uint64_t blocked = 0;
+        uint64_t internal = 0;
+        uint64_t expired = 0;
+        uint64_t filtered = 0;
+        uint64_t downsampled = 0;
+    };
+
+    /**
+     * @brief Get a snapshot of the reception counters.
+     *
+     * @returns The counters gathered since this Subscriber was created.
+     */
+    Statistics statistics() const;
+
+    /**
+     * @brief Print the reception queue counters, using the *Integration Service* logger.
+     */
+    void log_statistics();
 
 private:
 
+    /**
+     * @brief Behaviour of the reception queue when a new sample arrives and it is full.
+     */
+    enum class OverflowPolicy
+    {
+        BLOCK,
+        DROP_OLDEST,
+        DROP_NEWEST,
+        KEEP_LATEST
+    };
+
+    /**
+     * @brief A sample taken from the DataReader, pending to be converted and delivered.
+     */
+    struct Sample
+    {
+        fastrtps::types::DynamicData* data;
+        ::fastdds::dds::SampleInfo info;
+        OrderedExecutor::Key key;
+        uint64_t sequence;
+    };
+
+    /**
+     * @brief Reception thread entry point: process the samples queued for a key
+     *        and notify the cleaner thread.
+     *
+     * @param[in] key The dispatch key whose samples must be processed.
+     */
+    void receive(
+            OrderedExecutor::Key key);
+
+    /**
+     * @brief Handle the receiving of a batch of new messages from the DDS dataspace.
+     *
+     * @details Each sample is converted into its *xTypes* representation and its
+     *          DynamicData is given back to the pool. Afterwards, the whole batch
+     *          is delivered to the *Integration Service* at once, by means of Subscriber::deliver.
+     *
+     * @param[in] samples The incoming samples, in reception order.
+     */
+    void process(
+            std::vector<Sample>& samples);
+
+    /**
+     * @brief Hand a batch of converted messages over to every attached callback.
+     *
+     * @details The *Integration Service* core only accepts one message per callback call,
+     *          so each callback is triggered once per message, in reception order.
+     *
+     * @param[in] messages The converted messages.
+     *
+     * @param[in] infos The sample information associated to each message.
+     */
+    void deliver(
+            const std::vector<xtypes::DynamicData>& messages,
+            std::vector<::fastdds::dds::SampleInfo>& infos);
+
+    /**
+     * @brief Hand the processing of the next batch queued for a key over to the executor;
+     *        or launch a reception thread in charge of it, if there is no executor.
+     *
+     * @note Must be called with `cleaner_mtx_` locked.
+     *
+     * @param[in] key The dispatch key.
+     */
+    void dispatch(
+            OrderedExecutor::Key key);
+
+    /**
+     * @brief Overwrite the newest queued sample of an instance with a new sample of it.
+     *
+     * @note Must be called with `queue_mtx_` locked.
+     *
+     * @param[in] sample The new sample. On success, it gets the data of the overwritten sample,
+     *            which must be released.
+     *
+     * @returns `true` if a queued sample of the same instance was overwritten.
+     */
+    bool replace_latest(
+            Sample& sample);
+
+    /**
+     * @brief Insert a sample in the reception queue, conflating it if enabled, and applying
+     *        the overflow policy if the queue is full.
+     *
+     * @param[in] sample The sample to insert. Its data is released if the sample is discarded.
+     *
+     * @param[in] before_blocking Called, without holding the queue lock, right before the
+     *            listener blocks waiting for room; so that the samples already queued get dispatched.
+     *
+     * @returns `true` if the sample was queued as a new entry, which must be dispatched;
+     *          `false` if it was discarded or merged into an already queued entry.
+     */
+    bool enqueue(
+            Sample& sample,
+            const std::function<void()>& before_blocking);
+
+    /**
+     * @brief Extract the oldest samples queued for a key, up to the maximum batch size.
+     *
+     * @param[in] key The dispatch key.
+     *
+     * @returns The samples, in reception order. It may be empty, if they were dropped.
+     */
+    std::vector<Sample> dequeue(
+            OrderedExecutor::Key key);
+
+    /**
+     * @brief Get the current time, in the clock used by *Fast DDS* for source timestamps.
+     *
+     * @returns The nanoseconds since the epoch.
+     */
+    static int64_t current_time_ns();
+
+    /**
+     * @brief Check whether a sample is older than `max_age`.
+     *
+     * @param[in] info The sample information.
+     *
+     * @param[in] now_ns The current time, as given by current_time_ns().
+     *
+     * @returns `true` if `max_age` is set and the sample is older than it.
+     */
+    bool is_expired(
+            const ::fastdds::dds::SampleInfo& info,
+            int64_t now_ns) const;
+
+    /**
+     * @brief Compute the executor key for a sample, so that samples of the same
+     *        topic instance are processed in order.
+     *
+     * @param[in] info The sample information.
+     *
+     * @returns The executor key.
+     */
+    OrderedExecutor::Key dispatch_key(
+            const ::fastdds::dds::SampleInfo& info) const;
+
+    /**
+     * @brief Get a DynamicData from the pool, creating a new one if the pool is empty.
+     *
+     * @returns A DynamicData for this subscriber's topic type.
+     */
+    fastrtps::types::DynamicData* acquire_data();
+
+    /**
+     * @brief Give a DynamicData back to the pool, once its contents are no longer needed.
+     *
+     * @param[in] data The DynamicData to release.
+     */
+    void release_data(
+            fastrtps::types::DynamicData* data);
+
     /**
      * @brief Inherited from *DataReaderListener*.
      */
@@ -145,21 +415,68 @@ private:
      */
     void cleaner_function();
 
+    /**
+     * @brief Register the topic type, create the DDS topic, if needed, its content filtered
+     *        topic and the DataReader, along with the buffers and threads of the reception path.
+     *
+     * @throws DDSMiddlewareException if the type could not be registered or some DDS entity
+     *         could not be created.
+     */
+    void create_datareader();
+
     /**
      * Class members.
      */
     Participant* participant_;
+    ConversionContext* conversion_;
     ::fastdds::dds::Subscriber* dds_subscriber_;
     ::fastdds::dds::Topic* dds_topic_;
+    ::fastdds::dds::TopicDescription* dds_filtered_topic_;
+    std::string filtered_topic_name_;
     ::fastdds::dds::DataReader* dds_datareader_;
+    ::fastdds::dds::DataReaderQos datareader_qos_;
 
-    fastrtps::types::DynamicData* dynamic_data_;
+    std::vector<fastrtps::types::DynamicData*> data_pool_;
     std::mutex data_mtx_;
 
+    size_t max_batch_samples_;
+
+    std::shared_ptr<Projection> projection_;
+
+    // Only set when the filter cannot be applied by Fast DDS
+    std::unique_ptr<ContentFilter> filter_;
+
+    // Source timestamp of the last accepted sample of each instance, guarded by cleaner_mtx_
+    int64_t min_separation_ns_;
+    std::unordered_map<OrderedExecutor::Key, int64_t> last_accepted_ns_;
+
+    int64_t max_age_ns_;
+
+    std::unordered_map<OrderedExecutor::Key, std::deque<Sample> > queue_;
+    size_t queued_samples_;
+    size_t queue_depth_;
+    OverflowPolicy overflow_policy_;
+    bool conflate_;
+    uint64_t sequence_;
+    bool stop_queue_;
+    Statistics statistics_;
+    mutable std::mutex queue_mtx_;
+    std::condition_variable queue_cv_;
+
+    OrderedExecutor* executor_;
+    ReceptionWaitSet* waitset_;
+    const RealTime* realtime_;
+    OrderedExecutor::Key topic_key_;
+    fastrtps::rtps::GuidPrefix_t participant_prefix_;
+    size_t pending_tasks_;
+    std::mutex pending_mtx_;
+    std::condition_variable pending_cv_;
+
     const std::string topic_name_;
     const xtypes::DynamicType& message_type_;
 
-    TopicSubscriberSystem::SubscriptionCallback* is_callback_;
+    std::vector<TopicSubscriberSystem::SubscriptionCallback*> is_callbacks_;
+    std::mutex callbacks_mtx_;
 
     std::map<std::thread::id, std::thread*> reception_threads_;
     bool stop_cleaner_;
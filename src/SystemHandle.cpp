@@ -18,21 +18,46 @@
 #include <is/systemhandle/SystemHandle.hpp>
 #include <is/utils/Log.hpp>
 
+#include "OrderedExecutor.hpp"
 #include "Participant.hpp"
+#include "RealTime.hpp"
+#include "ReceptionWaitSet.hpp"
 #include "Publisher.hpp"
 #include "Subscriber.hpp"
 #include "Server.hpp"
 #include "Client.hpp"
 #include "Conversion.hpp"
 
+#include <chrono>
+#include <functional>
 #include <iostream>
+#include <mutex>
+#include <sstream>
 #include <thread>
+#include <unordered_map>
 
 namespace eprosima {
 namespace is {
 namespace sh {
 namespace fastdds {
 
+namespace {
+
+struct GUIDHash
+{
+    std::size_t operator ()(
+            const fastrtps::rtps::GUID_t& guid) const
+    {
+        // The writers of the several participants of the system may have the same entity ID
+        std::string bytes(reinterpret_cast<const char*>(guid.guidPrefix.value), sizeof(guid.guidPrefix.value));
+        bytes.append(reinterpret_cast<const char*>(guid.entityId.value), sizeof(guid.entityId.value));
+        return std::hash<std::string>()(bytes);
+    }
+
+};
+
+} //  anonymous namespace
+
 /**
  * @class SystemHandle
  *        This class represents a full *Integration Service* system handle or plugin for the *DDS*
@@ -49,6 +74,9 @@ public:
 
     SystemHandle()
         : FullSystem()
+        , startup_threads_(1)
+        , startup_failed_(false)
+        , statistics_period_(0)
         , logger_("is::sh::FastDDS")
     {
     }
@@ -69,18 +97,88 @@ public:
          */
         try
         {
-            if (configuration["participant"])
+            // Memory is locked before creating any DDS entity, so that all of them get locked
+            if (configuration["realtime"])
+            {
+                realtime_ = std::make_unique<RealTime>(configuration["realtime"]);
+                realtime_->lock_memory();
+            }
+
+            // Topics and services are sharded across several participants, so that each one
+            // gets its own Fast DDS receive and event threads
+            const std::size_t participants = configuration["participants"]
+                    ? configuration["participants"].as<std::size_t>()
+                    : 1;
+
+            if (0 == participants)
+            {
+                logger_ << utils::Logger::Level::ERROR
+                        << "The number of participants must be greater than 0" << std::endl;
+
+                return false;
+            }
+
+            const YAML::Node& participant_config = configuration["participant"];
+            if (1 < participants && participant_config.IsMap() && participant_config["transport"].IsMap()
+                    && participant_config["transport"]["listening_ports"])
+            {
+                logger_ << utils::Logger::Level::ERROR
+                        << "TCP listening ports cannot be shared by " << participants
+                        << " participants" << std::endl;
+
+                return false;
+            }
+
+            if (1 < participants && participant_config.IsMap() && participant_config["discovery"].IsMap()
+                    && participant_config["discovery"]["guid_prefix"])
             {
-                participant_ = std::make_unique<Participant>(configuration["participant"]);
+                logger_ << utils::Logger::Level::ERROR
+                        << "A GUID prefix cannot be shared by " << participants
+                        << " participants" << std::endl;
+
+                return false;
             }
-            else
+
+            if (1 < participants && participant_config.IsMap() && participant_config["static_discovery"])
+            {
+                logger_ << utils::Logger::Level::ERROR
+                        << "Static discovery cannot be used by " << participants
+                        << " participants" << std::endl;
+
+                return false;
+            }
+
+            if (!participant_config)
             {
                 logger_ << utils::Logger::Level::WARN
                         << "Participant not provided in configuration file. "
                         << "A participant using the default transport locators "
                         << "and Domain ID 0 will be created." << std::endl;
+            }
+
+            if (configuration["startup_threads"])
+            {
+                startup_threads_ = configuration["startup_threads"].as<std::size_t>();
+            }
+
+            for (std::size_t i = 0; i < participants; ++i)
+            {
+                participants_.emplace_back(participant_config
+                        ? std::make_unique<Participant>(participant_config, realtime_.get())
+                        : std::make_unique<Participant>(realtime_.get()));
 
-                participant_ = std::make_unique<Participant>();
+                // Created in parallel on the first spin, once every topic has been registered
+                if (1 < startup_threads_)
+                {
+                    participants_.back()->defer_endpoints();
+                }
+            }
+
+            if (1 < participants)
+            {
+                logger_ << utils::Logger::Level::INFO
+                        << "Topics and services will be distributed across " << participants
+                        << " participants" << std::endl;
             }
         }
         catch (DDSMiddlewareException& e)
@@ -89,6 +187,86 @@ public:
             return false;
         }
 
+        // Options of the topics which do not configure their own
+        if (configuration["partitions"])
+        {
+            topic_defaults_["partitions"] = YAML::Clone(configuration["partitions"]);
+        }
+
+        if (configuration["lazy_endpoints"])
+        {
+            topic_defaults_["lazy"] = YAML::Clone(configuration["lazy_endpoints"]);
+        }
+
+        std::function<void()> thread_init;
+        if (realtime_)
+        {
+            thread_init = [realtime = realtime_.get()]()
+                    {
+                        realtime->configure_current_thread();
+                    };
+        }
+
+        if (configuration["dispatch"])
+        {
+            try
+            {
+                executor_ = OrderedExecutor::create(configuration["dispatch"], thread_init);
+            }
+            catch (DDSMiddlewareException& e)
+            {
+                e.from_logger << utils::Logger::Level::ERROR << e.what() << std::endl;
+                return false;
+            }
+
+            if (executor_)
+            {
+                logger_ << utils::Logger::Level::INFO
+                        << "Incoming samples will be dispatched in order per topic instance, "
+                        << "using " << executor_->size() << " threads" << std::endl;
+            }
+        }
+
+        if (configuration["reception"])
+        {
+            const YAML::Node& reception = configuration["reception"];
+            const std::string mode = reception["mode"] ? reception["mode"].as<std::string>() : "listener";
+
+            if ("waitset" == mode)
+            {
+                std::size_t threads = reception["threads"] ? reception["threads"].as<std::size_t>() : 1;
+
+                try
+                {
+                    waitset_ = std::make_unique<ReceptionWaitSet>(threads, thread_init);
+                }
+                catch (DDSMiddlewareException& e)
+                {
+                    e.from_logger << utils::Logger::Level::ERROR << e.what() << std::endl;
+                    return false;
+                }
+
+                logger_ << utils::Logger::Level::INFO
+                        << "DataReader events will be handled from " << waitset_->size()
+                        << " WaitSet threads, instead of from listeners" << std::endl;
+            }
+            else if ("listener" != mode)
+            {
+                logger_ << utils::Logger::Level::ERROR
+                        << "Unknown reception mode '" << mode << "'. Allowed values are "
+                        << "'listener' and 'waitset'" << std::endl;
+
+                return false;
+            }
+        }
+
+        if (configuration["statistics"] && configuration["statistics"]["period_ms"])
+        {
+            statistics_period_ = std::chrono::milliseconds(
+                configuration["statistics"]["period_ms"].as<std::size_t>());
+            last_statistics_ = std::chrono::steady_clock::now();
+        }
+
         logger_ << utils::Logger::Level::INFO << "Configured!" << std::endl;
 
         return true;
@@ -96,13 +274,71 @@ public:
 
     bool okay() const override
     {
-        return (nullptr != participant_->get_dds_participant());
+        if (startup_failed_)
+        {
+            return false;
+        }
+
+        for (const auto& participant : participants_)
+        {
+            if (nullptr == participant->get_dds_participant())
+            {
+                return false;
+            }
+        }
+
+        return !participants_.empty();
     }
 
     bool spin_once() override
     {
         using namespace std::chrono_literals;
+
+        // Endpoints deferred during startup, only the first time, and before sleeping so that
+        // the window in which the messages published into DDS are discarded is as short as possible
+        for (const auto& participant : participants_)
+        {
+            if (!participant->create_deferred_endpoints(startup_threads_) && !startup_failed_)
+            {
+                startup_failed_ = true;
+
+                logger_ << utils::Logger::Level::ERROR
+                        << "Some of the topics could not be created at startup, stopping the system"
+                        << std::endl;
+            }
+        }
+
         std::this_thread::sleep_for(100ms);
+
+        for (const auto& participant : participants_)
+        {
+            // Deferred endpoints whose remote counterpart was discovered meanwhile are created
+            if (!participant->create_discovered_endpoints(
+                        [this](const fastrtps::rtps::GuidPrefix_t& prefix)
+                        {
+                            return is_own_participant(prefix);
+                        }) && !startup_failed_)
+            {
+                startup_failed_ = true;
+
+                logger_ << utils::Logger::Level::ERROR
+                        << "Some of the topics could not be created on discovery, stopping the system"
+                        << std::endl;
+            }
+
+            // The endpoints created so far are announced to the peers using static discovery
+            participant->write_static_endpoints();
+        }
+
+        if (0ms < statistics_period_ && statistics_period_ <= std::chrono::steady_clock::now() - last_statistics_)
+        {
+            last_statistics_ = std::chrono::steady_clock::now();
+            for (auto& pair : subscribers_)
+            {
+                pair.second->log_statistics();
+            }
+        }
+
         return okay();
     }
 
@@ -110,14 +346,52 @@ public:
             const std::string& topic_name,
             const xtypes::DynamicType& message_type,
             SubscriptionCallback* callback,
-            const YAML::Node& /* configuration */) override
+            const YAML::Node& configuration) override
     {
+        const YAML::Node topic_configuration = with_topic_defaults(configuration);
+
+        // One DataReader per topic and reader options: further subscriptions to the same topic,
+        // with the same options, share it.
+        std::string subscriber_key = topic_name;
+        for (const char* option : {"filter", "partitions", "fields", "max_age", "min_separation", "max_rate",
+                                   "queue", "batch", "data_sharing", "lazy", "participant_index"})
+        {
+            if (topic_configuration[option])
+            {
+                subscriber_key += std::string(" | ") + option + ": " + YAML::Dump(topic_configuration[option]);
+            }
+        }
+
+        auto subscriber_it = subscribers_.find(subscriber_key);
+        if (subscribers_.end() != subscriber_it)
+        {
+            const std::shared_ptr<Subscriber>& subscriber = subscriber_it->second;
+            if (subscriber->message_type().name() != message_type.name())
+            {
+                logger_ << utils::Logger::Level::ERROR
+                        << "Cannot subscribe to topic '" << topic_name << "' with type '"
+                        << message_type.name() << "': it is already subscribed with type '"
+                        << subscriber->message_type().name() << "'" << std::endl;
+
+                return false;
+            }
+
+            subscriber->add_callback(callback);
+
+            logger_ << utils::Logger::Level::INFO
+                    << "Subscription to topic '" << topic_name << "', with type '"
+                    << message_type.name() << "' attached to the existing subscriber" << std::endl;
+
+            return true;
+        }
+
         try
         {
             auto subscriber = std::make_shared<Subscriber>(
-                participant_.get(), topic_name, message_type, callback);
+                select_participant(topic_name, topic_configuration), &conversion_, topic_name, message_type, callback,
+                topic_configuration, executor_.get(), waitset_.get(), realtime_.get());
 
-            subscribers_.emplace_back(std::move(subscriber));
+            subscribers_.emplace(subscriber_key, std::move(subscriber));
 
             logger_ << utils::Logger::Level::INFO
                     << "Subscriber created for topic '" << topic_name << "', with type '"
@@ -139,20 +413,19 @@ public:
 
         auto sample_writer_guid = fastrtps::rtps::iHandle2GUID(sample_info->publication_handle);
 
-        if (sample_writer_guid.guidPrefix == participant_->get_dds_participant()->guid().guidPrefix)
+        // Subscribers already drop the samples published from their own participant before
+        // converting them; the samples of the other participants are discarded here
+        if (is_own_participant(sample_writer_guid.guidPrefix))
         {
             if (utils::Logger::Level::DEBUG == logger_.get_level())
             {
-                for (const auto& publisher : publishers_)
+                std::unique_lock<std::mutex> lock(publisher_topics_mtx_);
+                auto publisher_it = publisher_topics_.find(sample_writer_guid);
+                if (publisher_topics_.end() != publisher_it)
                 {
-                    if (sample_writer_guid == fastrtps::rtps::iHandle2GUID(publisher->get_dds_instance_handle()))
-                    {
-                        logger_ << utils::Logger::Level::DEBUG
-                                << "Received internal message from publisher '"
-                                << publisher->topic_name() << "', ignoring it..." << std::endl;
-
-                        break;
-                    }
+                    logger_ << utils::Logger::Level::DEBUG
+                            << "Received internal message from publisher '"
+                            << publisher_it->second << "', ignoring it..." << std::endl;
                 }
             }
             // This is a message published FROM Integration Service. Discard it.
@@ -169,8 +442,15 @@ public:
     {
         try
         {
+            // Lazy and deferred DataWriters are created later, from other threads
             auto publisher = std::make_shared<Publisher>(
-                participant_.get(), topic_name, message_type, configuration);
+                select_participant(topic_name, configuration), &conversion_, topic_name, message_type,
+                with_topic_defaults(configuration),
+                [this, topic_name](const fastrtps::rtps::GUID_t& guid)
+                {
+                    std::unique_lock<std::mutex> lock(publisher_topics_mtx_);
+                    publisher_topics_.emplace(guid, topic_name);
+                });
             publishers_.emplace_back(std::move(publisher));
 
             logger_ << utils::Logger::Level::INFO
@@ -207,12 +487,15 @@ public:
             try
             {
                 auto client = std::make_shared<Client>(
-                    participant_.get(),
+                    select_participant(service_name, configuration),
+                    &conversion_,
                     service_name,
                     request_type,
                     reply_type,
                     callback,
-                    configuration);
+                    configuration,
+                    waitset_.get(),
+                    realtime_.get());
 
                 clients_[service_name] = std::move(client);
 
@@ -253,11 +536,14 @@ public:
             try
             {
                 auto server = std::make_shared<Server>(
-                    participant_.get(),
+                    select_participant(service_name, configuration),
+                    &conversion_,
                     service_name,
                     request_type,
                     reply_type,
-                    configuration);
+                    configuration,
+                    waitset_.get(),
+                    realtime_.get());
 
                 servers_[service_name] = std::move(server);
 
@@ -287,11 +573,101 @@ public:
 
 private:
 
-    std::unique_ptr<Participant> participant_;
+    /**
+     * @brief Get the configuration of a topic, adding the system defaults of the options
+     *        (`partitions` and `lazy`) that the topic does not configure.
+     */
+    YAML::Node with_topic_defaults(
+            const YAML::Node& configuration) const
+    {
+        std::vector<std::string> missing;
+        for (const auto& option : topic_defaults_)
+        {
+            if (!configuration[option.first])
+            {
+                missing.push_back(option.first);
+            }
+        }
+
+        if (missing.empty())
+        {
+            return configuration;
+        }
+
+        YAML::Node topic_configuration = YAML::Clone(configuration);
+        for (const std::string& option : missing)
+        {
+            topic_configuration[option] = topic_defaults_.at(option);
+        }
+        return topic_configuration;
+    }
+
+    /**
+     * @brief Get the participant in charge of a topic or service: the one given by its
+     *        `participant_index` option or, by default, one chosen by hashing its name,
+     *        so that the publishers and subscribers of a topic share their participant.
+     *
+     * @throws DDSMiddlewareException If the `participant_index` is out of range.
+     */
+    Participant* select_participant(
+            const std::string& name,
+            const YAML::Node& configuration) const
+    {
+        std::size_t index = std::hash<std::string>()(name) % participants_.size();
+
+        if (configuration["participant_index"])
+        {
+            index = configuration["participant_index"].as<std::size_t>();
+            if (participants_.size() <= index)
+            {
+                std::ostringstream err;
+                err << "The participant_index " << index << " of '" << name << "' is out of range: "
+                    << "the system has " << participants_.size() << " participants";
+
+                throw DDSMiddlewareException(logger_, err.str());
+            }
+        }
+
+        return participants_[index].get();
+    }
+
+    /**
+     * @brief Check whether a GUID prefix belongs to one of the participants of this system.
+     */
+    bool is_own_participant(
+            const fastrtps::rtps::GuidPrefix_t& prefix) const
+    {
+        for (const auto& participant : participants_)
+        {
+            if (prefix == participant->get_dds_participant()->guid().guidPrefix)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    std::unique_ptr<RealTime> realtime_;
+
+    // Outlives every entity, and its type builders are released along with the system
+    ConversionContext conversion_;
+
+    std::vector<std::unique_ptr<Participant> > participants_;
+    std::unique_ptr<OrderedExecutor> executor_;
+    std::unique_ptr<ReceptionWaitSet> waitset_;
     std::vector<std::shared_ptr<Publisher> > publishers_;
-    std::vector<std::shared_ptr<Subscriber> > subscribers_;
+    std::unordered_map<fastrtps::rtps::GUID_t, std::string, GUIDHash> publisher_topics_;
+    std::mutex publisher_topics_mtx_;
+    std::map<std::string, std::shared_ptr<Subscriber> > subscribers_;
     std::map<std::string, std::shared_ptr<Client> > clients_;
     std::map<std::string, std::shared_ptr<Server> > servers_;
+    std::map<std::string, YAML::Node> topic_defaults_;
+    std::size_t startup_threads_;
+    bool startup_failed_;
+
+    std::chrono::milliseconds statistics_period_;
+    std::chrono::steady_clock::time_point last_statistics_;
 
     utils::Logger logger_;
 };
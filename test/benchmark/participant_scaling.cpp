@@ -0,0 +1,212 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/**
+ * Measures the reception throughput of the System Handle when its topics are distributed
+ * across 1, 2, 4... participants, as done by the `participants` option of the system.
+ * A child process publishes, as fast as it can, on every topic from one thread per topic;
+ * while the parent process subscribes to them and counts the samples delivered after being
+ * converted, for each number of participants.
+ *
+ * Usage: is-fastdds-participant-scaling [topics] [seconds] [max_participants]
+ *
+ * The publisher runs in its own process, so that *Fast DDS* intraprocess delivery does not
+ * bypass the receive threads of the participants being measured.
+ */
+
+#include <Conversion.hpp>
+#include <OrderedExecutor.hpp>
+#include <Participant.hpp>
+#include <Publisher.hpp>
+#include <Subscriber.hpp>
+
+#include <xtypes/idl/idl.hpp>
+#include <yaml-cpp/yaml.h>
+
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace eprosima::is;
+using namespace eprosima::is::sh::fastdds;
+
+namespace {
+
+const std::string sample_idl =
+        R"(
+            struct ScalingSample
+            {
+                uint32 index;
+                string payload;
+            };
+        )";
+
+std::string topic_name(
+        std::size_t index)
+{
+    return "participant_scaling_" + std::to_string(index);
+}
+
+[[noreturn]] void publish(
+        const eprosima::xtypes::DynamicType& type,
+        std::size_t topics)
+{
+    ConversionContext conversion;
+    Participant participant;
+
+    std::vector<std::unique_ptr<Publisher> > publishers;
+    for (std::size_t i = 0; i < topics; ++i)
+    {
+        publishers.emplace_back(std::make_unique<Publisher>(
+                    &participant, &conversion, topic_name(i), type, YAML::Node()));
+    }
+
+    std::vector<std::thread> threads;
+    for (const std::unique_ptr<Publisher>& publisher : publishers)
+    {
+        threads.emplace_back([&type, publisher = publisher.get()]()
+                {
+                    eprosima::xtypes::DynamicData data(type);
+                    data["payload"] = std::string(256, 'x');
+                    for (uint32_t index = 0;; ++index)
+                    {
+                        data["index"] = index;
+                        publisher->publish(data);
+                    }
+                });
+    }
+
+    // Publishes until killed by the parent process
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    std::exit(0);
+}
+
+double measure(
+        const eprosima::xtypes::DynamicType& type,
+        std::size_t topics,
+        std::size_t participants,
+        std::chrono::seconds duration)
+{
+    std::atomic<uint64_t> received(0);
+    TopicSubscriberSystem::SubscriptionCallback callback =
+            [&received](const eprosima::xtypes::DynamicData& /*message*/, void* /*filter_handle*/)
+            {
+                ++received;
+            };
+
+    OrderedExecutor executor(std::max(1u, std::thread::hardware_concurrency()));
+    ConversionContext conversion;
+
+    // Subscriptions are destroyed before their participants
+    std::vector<std::unique_ptr<Participant> > shards;
+    for (std::size_t i = 0; i < participants; ++i)
+    {
+        shards.emplace_back(std::make_unique<Participant>());
+    }
+
+    std::vector<std::unique_ptr<Subscriber> > subscribers;
+    for (std::size_t i = 0; i < topics; ++i)
+    {
+        // Same distribution as the System Handle
+        Participant* shard = shards[std::hash<std::string>()(topic_name(i)) % participants].get();
+        subscribers.emplace_back(std::make_unique<Subscriber>(
+                    shard, &conversion, topic_name(i), type, &callback, YAML::Node(), &executor));
+    }
+
+    // Let discovery finish before counting
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+
+    const uint64_t start_count = received;
+    const auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(duration);
+    const uint64_t count = received - start_count;
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    subscribers.clear();
+    return static_cast<double>(count) / elapsed;
+}
+
+} //  anonymous namespace
+
+int main(
+        int argc,
+        char** argv)
+{
+    const std::size_t topics = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 16;
+    const std::chrono::seconds duration(argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 5);
+    const std::size_t max_participants = argc > 3
+            ? std::strtoul(argv[3], nullptr, 10)
+            : std::max(1u, std::thread::hardware_concurrency() / 2);
+
+    if (0 == topics || 0 == max_participants)
+    {
+        std::cerr << "Usage: " << argv[0] << " [topics] [seconds] [max_participants]" << std::endl;
+        return 1;
+    }
+
+    eprosima::xtypes::idl::Context context = eprosima::xtypes::idl::parse(sample_idl);
+    if (!context.success)
+    {
+        std::cerr << "Invalid sample type" << std::endl;
+        return 1;
+    }
+    eprosima::xtypes::DynamicType::Ptr type = context.module().type("ScalingSample");
+
+    // Forked before any DDS entity exists, as their threads would not survive the fork
+    pid_t publisher_pid = fork();
+    if (0 > publisher_pid)
+    {
+        std::cerr << "Could not launch the publisher process" << std::endl;
+        return 1;
+    }
+    else if (0 == publisher_pid)
+    {
+        publish(*type, topics);
+    }
+
+    std::cout << "Reception throughput of " << topics << " topics, over " << duration.count()
+              << " s per run" << std::endl;
+
+    for (std::size_t participants = 1; participants <= max_participants; participants *= 2)
+    {
+        const double throughput = measure(*type, topics, participants, duration);
+        std::cout << std::setw(4) << participants << " participants "
+                  << std::fixed << std::setprecision(0) << std::setw(12) << throughput
+                  << " samples/s" << std::endl;
+    }
+
+    kill(publisher_pid, SIGKILL);
+    waitpid(publisher_pid, nullptr, 0);
+
+    return 0;
+}
@@ -0,0 +1,191 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/**
+ * Measures the dispatch latency of the reception workers, that is, the time elapsed since a
+ * sample is handed over to the OrderedExecutor until a worker starts processing it, while
+ * other threads load every CPU core. The measure is run twice: with default thread settings,
+ * and with the settings of the `realtime` section, given as a YAML file.
+ *
+ * Usage: is-fastdds-realtime-jitter <realtime.yaml> [samples] [period_us]
+ *
+ * Example realtime.yaml:
+ *
+ *     cpus: [3]
+ *     scheduler: fifo
+ *     priority: 80
+ *     lock_memory: true
+ *
+ * The SCHED_FIFO and memory locking settings require CAP_SYS_NICE and CAP_IPC_LOCK
+ * (e.g. running as root); otherwise, a warning is printed and they are not applied.
+ */
+
+#include <OrderedExecutor.hpp>
+#include <RealTime.hpp>
+
+#include <yaml-cpp/yaml.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace eprosima::is::sh::fastdds;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Percentiles
+{
+    double p50;
+    double p99;
+    double p999;
+    double max;
+};
+
+Percentiles compute_percentiles(
+        std::vector<double> latencies)
+{
+    std::sort(latencies.begin(), latencies.end());
+
+    auto at = [&latencies](double ratio)
+            {
+                size_t index = static_cast<size_t>(ratio * static_cast<double>(latencies.size() - 1));
+                return latencies[index];
+            };
+
+    return Percentiles{at(0.5), at(0.99), at(0.999), latencies.back()};
+}
+
+Percentiles measure(
+        const RealTime* realtime,
+        size_t samples,
+        std::chrono::microseconds period)
+{
+    std::vector<double> latencies(samples, 0.0);
+
+    // Background load: busy threads allocating memory on every core
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> load;
+    for (unsigned i = 0; i < std::max(1u, std::thread::hardware_concurrency()); ++i)
+    {
+        load.emplace_back([&stop]()
+                {
+                    while (!stop)
+                    {
+                        std::vector<char> garbage(64 * 1024, 1);
+                        volatile char sink = garbage[garbage.size() / 2];
+                        (void)sink;
+                    }
+                });
+    }
+
+    {
+        OrderedExecutor::ThreadInit thread_init;
+        if (nullptr != realtime)
+        {
+            thread_init = [realtime]()
+                    {
+                        realtime->configure_current_thread();
+                    };
+        }
+
+        OrderedExecutor executor(1, thread_init);
+
+        Clock::time_point next = Clock::now();
+        for (size_t i = 0; i < samples; ++i)
+        {
+            next += period;
+            std::this_thread::sleep_until(next);
+
+            Clock::time_point submitted = Clock::now();
+            executor.submit(0, [&latencies, i, submitted]()
+                    {
+                        latencies[i] = std::chrono::duration<double, std::micro>(
+                            Clock::now() - submitted).count();
+                    });
+        }
+        // Destruction waits for every pending task
+    }
+
+    stop = true;
+    for (std::thread& thread : load)
+    {
+        thread.join();
+    }
+
+    return compute_percentiles(std::move(latencies));
+}
+
+void print(
+        const std::string& name,
+        const Percentiles& result)
+{
+    std::cout << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(1)
+              << " p50 " << std::setw(9) << result.p50 << " us"
+              << "   p99 " << std::setw(9) << result.p99 << " us"
+              << "   p99.9 " << std::setw(9) << result.p999 << " us"
+              << "   max " << std::setw(9) << result.max << " us" << std::endl;
+}
+
+} //  anonymous namespace
+
+int main(
+        int argc,
+        char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <realtime.yaml> [samples] [period_us]" << std::endl;
+        return 1;
+    }
+
+    const size_t samples = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20000;
+    const std::chrono::microseconds period(argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 500);
+
+    if (0 == samples)
+    {
+        std::cerr << "The number of samples must be greater than 0" << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<RealTime> realtime;
+    try
+    {
+        realtime = std::make_unique<RealTime>(YAML::LoadFile(argv[1]));
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Invalid realtime configuration: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Dispatch latency over " << samples << " samples, one every "
+              << period.count() << " us, with all cores loaded" << std::endl;
+
+    print("default", measure(nullptr, samples, period));
+
+    realtime->lock_memory();
+    print("realtime", measure(realtime.get(), samples, period));
+
+    return 0;
+}
@@ -0,0 +1,233 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/**
+ * Measures how the startup and teardown of an *Integration Service* instance, with a Fast DDS
+ * system, scale with the number of topics and types. For 10, 100, 1000... topics, a YAML
+ * configuration is generated, where half of the topics are published into DDS and the other
+ * half are subscribed from DDS, using a mock system on the other side of the routes. The
+ * topics cycle through `topics / topics_per_type` different types, of several shapes.
+ *
+ * Usage: is-fastdds-startup-scaling [max_topics] [topics_per_type]
+ *
+ * Each configuration runs in its own process, so that the resident memory and threads left
+ * by a run are not accounted to the next one.
+ */
+
+#include <is/core/Instance.hpp>
+
+#include <yaml-cpp/yaml.h>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+using namespace eprosima;
+
+namespace {
+
+struct ProcessStatus
+{
+    std::size_t rss_kb = 0;
+    std::size_t threads = 0;
+};
+
+ProcessStatus process_status()
+{
+    ProcessStatus status;
+
+    std::ifstream proc_status("/proc/self/status");
+    std::string field;
+    while (proc_status >> field)
+    {
+        if ("VmRSS:" == field)
+        {
+            proc_status >> status.rss_kb;
+        }
+        else if ("Threads:" == field)
+        {
+            proc_status >> status.threads;
+        }
+    }
+
+    return status;
+}
+
+std::string type_name(
+        std::size_t index)
+{
+    return "ScalingType_" + std::to_string(index);
+}
+
+std::string type_idl(
+        std::size_t index)
+{
+    std::string s;
+    s += "            struct " + type_name(index) + "\n";
+    s += "            {\n";
+    s += "                uint32 index;\n";
+
+    // Mix flat, unbounded and nested types
+    switch (index % 3)
+    {
+        case 0:
+        {
+            s += "                double value;\n";
+            s += "                string name;\n";
+            break;
+        }
+        case 1:
+        {
+            s += "                sequence<float> values;\n";
+            s += "                uint64 stamp;\n";
+            break;
+        }
+        default:
+        {
+            s += "                ScalingPoint position;\n";
+            s += "                string frame_id;\n";
+            break;
+        }
+    }
+
+    s += "            };\n";
+    return s;
+}
+
+std::string gen_config_yaml(
+        std::size_t topics,
+        std::size_t types)
+{
+    std::string s;
+    s += "types:\n";
+    s += "    idls:\n";
+    s += "        - >\n";
+    s += "            struct ScalingPoint\n";
+    s += "            {\n";
+    s += "                double x;\n";
+    s += "                double y;\n";
+    s += "                double z;\n";
+    s += "            };\n";
+    for (std::size_t i = 0; i < types; ++i)
+    {
+        s += type_idl(i);
+    }
+
+    s += "systems:\n";
+    s += "    dds: { type: fastdds }\n";
+    s += "    mock: { type: mock }\n";
+
+    s += "routes:\n";
+    s += "    mock_to_dds: { from: mock, to: dds }\n";
+    s += "    dds_to_mock: { from: dds, to: mock }\n";
+
+    s += "topics:\n";
+    for (std::size_t i = 0; i < topics; ++i)
+    {
+        s += "    startup_scaling_" + std::to_string(i) + ": { type: \"" + type_name(i % types) + "\", route: "
+                + (i % 2 ? "dds_to_mock" : "mock_to_dds") + " }\n";
+    }
+
+    return s;
+}
+
+[[noreturn]] void measure(
+        std::size_t topics,
+        std::size_t types)
+{
+    const YAML::Node config_node = YAML::Load(gen_config_yaml(topics, types));
+    const ProcessStatus initial = process_status();
+
+    const auto start = std::chrono::steady_clock::now();
+    auto instance = std::make_unique<is::core::InstanceHandle>(is::run_instance(config_node));
+    const double startup = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!*instance)
+    {
+        std::cerr << "Could not start the instance with " << topics << " topics" << std::endl;
+        std::exit(1);
+    }
+
+    const ProcessStatus running = process_status();
+
+    const auto stop = std::chrono::steady_clock::now();
+    instance->quit().wait();
+    instance.reset();
+    const double teardown = std::chrono::duration<double>(std::chrono::steady_clock::now() - stop).count();
+
+    std::cout << std::setw(7) << topics << " topics " << std::setw(6) << types << " types "
+              << std::fixed << std::setprecision(3)
+              << std::setw(10) << startup << " s startup "
+              << std::setw(10) << (running.rss_kb - std::min(running.rss_kb, initial.rss_kb)) / 1024.0 << " MiB RSS "
+              << std::setw(5) << running.threads << " threads "
+              << std::setw(10) << teardown << " s teardown" << std::endl;
+    std::exit(0);
+}
+
+} //  anonymous namespace
+
+int main(
+        int argc,
+        char** argv)
+{
+    const std::size_t max_topics = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+    const std::size_t topics_per_type = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4;
+
+    if (10 > max_topics || 0 == topics_per_type)
+    {
+        std::cerr << "Usage: " << argv[0] << " [max_topics] [topics_per_type]" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Startup and teardown of the instance, with " << topics_per_type
+              << " topics per type" << std::endl;
+
+    for (std::size_t topics = 10; topics <= max_topics; topics *= 10)
+    {
+        const std::size_t types = std::max<std::size_t>(1, topics / topics_per_type);
+
+        pid_t pid = fork();
+        if (0 > pid)
+        {
+            std::cerr << "Could not launch the process for " << topics << " topics" << std::endl;
+            return 1;
+        }
+        else if (0 == pid)
+        {
+            measure(topics, types);
+        }
+
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || 0 != WEXITSTATUS(status))
+        {
+            std::cerr << "The run with " << topics << " topics failed" << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
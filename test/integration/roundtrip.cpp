@@ -42,6 +42,7 @@
 
 #include <is/utils/Log.hpp>
 
+#include <condition_variable>
 #include <iostream>
 #include <iomanip>
 #include <ctime>
@@ -70,7 +71,8 @@ class FastDDSPubsubTest
 public:
 
     FastDDSPubsubTest(
-            std::mutex& mtx)
+            std::mutex& mtx,
+            const std::vector<std::string>& partitions = {})
         : ::fastdds::dds::DataReaderListener()
         , participant_factory_(::fastdds::dds::DomainParticipantFactory::get_instance())
         , mutex_(mtx)
@@ -95,7 +97,7 @@ public:
             }
 
             fastrtps::types::DynamicTypeBuilder* builder =
-                    Conversion::create_builder(*type);
+                    conversion_.create_builder(*type);
             if (!builder)
             {
                 throw DDSMiddlewareException(
@@ -145,7 +147,12 @@ public:
         }
 
         // Create publisher entities
-        publisher_ = participant_->create_publisher(::fastdds::dds::PUBLISHER_QOS_DEFAULT);
+        ::fastdds::dds::PublisherQos publisher_qos = ::fastdds::dds::PUBLISHER_QOS_DEFAULT;
+        for (const std::string& partition : partitions)
+        {
+            publisher_qos.partition().push_back(partition.c_str());
+        }
+        publisher_ = participant_->create_publisher(publisher_qos);
 
         if (!publisher_)
         {
@@ -164,7 +171,12 @@ public:
         }
 
         // Create subscriber entities
-        subscriber_ = participant_->create_subscriber(::fastdds::dds::SUBSCRIBER_QOS_DEFAULT);
+        ::fastdds::dds::SubscriberQos subscriber_qos = ::fastdds::dds::SUBSCRIBER_QOS_DEFAULT;
+        for (const std::string& partition : partitions)
+        {
+            subscriber_qos.partition().push_back(partition.c_str());
+        }
+        subscriber_ = participant_->create_subscriber(subscriber_qos);
 
         if (!subscriber_)
         {
@@ -273,6 +285,7 @@ private:
     ::fastdds::dds::Publisher* publisher_;
     ::fastdds::dds::DataWriter* datawriter_;
 
+    ConversionContext conversion_;
     fastrtps::types::DynamicPubSubType tsType_;
 
     std::mutex& mutex_;
@@ -375,7 +388,7 @@ public:
                     }
 
                     fastrtps::types::DynamicTypeBuilder* builder =
-                            Conversion::create_builder(*type);
+                            conversion_.create_builder(*type);
                     if (!builder)
                     {
                         throw DDSMiddlewareException(
@@ -614,6 +627,7 @@ private:
     ::fastdds::dds::Topic* pub_topic_;
     ::fastdds::dds::DataWriter* datawriter_;
 
+    ConversionContext conversion_;
     fastrtps::types::DynamicPubSubType tsType_req_;
     fastrtps::types::DynamicPubSubType tsType_rep_;
 
@@ -1513,6 +1527,422 @@ TEST(FastDDS, Request_to_and_reply_from_mock_server_to_dds_client)
     ASSERT_EQ(0, instance.quit().wait_for(1s));
 }
 
+TEST(FastDDS, Shared_subscriber_delivers_to_every_route)
+{
+    // Both subscribed topics are remapped to the DDS topic echoed by FastDDSPubsubTest, with the
+    // same options, so they share a single subscriber
+    const std::string remap = ", remap: {dds: { topic: \"mock_to_dds_topicdds_to_mock_topic\" } }";
+
+    std::string config_yaml;
+    config_yaml += "types:\n";
+    config_yaml += "    idls:\n";
+    config_yaml += "        - >\n";
+    config_yaml += "            struct dds_test_string\n";
+    config_yaml += "            {\n";
+    config_yaml += "                string data;\n";
+    config_yaml += "            };\n";
+    config_yaml += "systems:\n";
+    config_yaml += "    dds: { type: fastdds }\n";
+    config_yaml += "    mock: { type: mock }\n";
+    config_yaml += "routes:\n";
+    config_yaml += "    mock_to_dds: { from: mock, to: dds }\n";
+    config_yaml += "    dds_to_mock: { from: dds, to: mock }\n";
+    config_yaml += "topics:\n";
+    config_yaml += "    mock_to_dds_topic: { type: dds_test_string, route: mock_to_dds" + remap + " }\n";
+    config_yaml += "    dds_to_mock_topic: { type: dds_test_string, route: dds_to_mock" + remap + " }\n";
+    config_yaml += "    dds_to_mock_topic_2: { type: dds_test_string, route: dds_to_mock" + remap + " }\n";
+
+    is::core::InstanceHandle instance = is::run_instance(YAML::Load(config_yaml));
+    ASSERT_TRUE(instance);
+
+    std::mutex disc_mutex;
+    disc_mutex.lock();
+
+    std::unique_ptr<FastDDSPubsubTest> dds_echo = nullptr;
+    ASSERT_NO_THROW(dds_echo.reset(new FastDDSPubsubTest(disc_mutex)));
+
+    disc_mutex.lock();
+
+    std::promise<std::string> first_promise;
+    std::promise<std::string> second_promise;
+    ASSERT_TRUE(is::sh::mock::subscribe(
+                "dds_to_mock_topic",
+                [&](const eprosima::xtypes::DynamicData& msg)
+                {
+                    first_promise.set_value(msg["data"].value<std::string>());
+                }));
+    ASSERT_TRUE(is::sh::mock::subscribe(
+                "dds_to_mock_topic_2",
+                [&](const eprosima::xtypes::DynamicData& msg)
+                {
+                    second_promise.set_value(msg["data"].value<std::string>());
+                }));
+
+    const is::TypeRegistry& mock_types = *instance.type_registry("mock");
+    eprosima::xtypes::DynamicData msg_to_sent(*mock_types.at("dds_test_string"));
+    msg_to_sent["data"] = std::string("shared subscriber");
+    is::sh::mock::publish_message("mock_to_dds_topic", msg_to_sent);
+
+    // Road: [mock -> dds -> dds -> mock (x2)]
+    auto first_future = first_promise.get_future();
+    auto second_future = second_promise.get_future();
+    ASSERT_EQ(std::future_status::ready, first_future.wait_for(5s));
+    ASSERT_EQ(std::future_status::ready, second_future.wait_for(5s));
+    EXPECT_EQ("shared subscriber", first_future.get());
+    EXPECT_EQ("shared subscriber", second_future.get());
+
+    ASSERT_EQ(0, instance.quit().wait_for(1s));
+}
+
+TEST(FastDDS, Subscription_with_other_type_is_rejected)
+{
+    // Two subscriptions to the same DDS topic, with the same options, but different types
+    std::string config_yaml;
+    config_yaml += "types:\n";
+    config_yaml += "    idls:\n";
+    config_yaml += "        - >\n";
+    config_yaml += "            struct dds_test_string\n";
+    config_yaml += "            {\n";
+    config_yaml += "                string data;\n";
+    config_yaml += "            };\n";
+    config_yaml += "            struct dds_test_other_string\n";
+    config_yaml += "            {\n";
+    config_yaml += "                string data;\n";
+    config_yaml += "            };\n";
+    config_yaml += "systems:\n";
+    config_yaml += "    dds: { type: fastdds }\n";
+    config_yaml += "    mock: { type: mock }\n";
+    config_yaml += "routes:\n";
+    config_yaml += "    dds_to_mock: { from: dds, to: mock }\n";
+    config_yaml += "topics:\n";
+    config_yaml += "    first_topic: { type: dds_test_string, route: dds_to_mock, "
+            "remap: {dds: { topic: shared_dds_topic } } }\n";
+    config_yaml += "    second_topic: { type: dds_test_other_string, route: dds_to_mock, "
+            "remap: {dds: { topic: shared_dds_topic } } }\n";
+
+    is::core::InstanceHandle instance = is::run_instance(YAML::Load(config_yaml));
+    EXPECT_FALSE(instance);
+}
+
+/**
+ * Configuration with the given options for the Fast DDS system and for each topic. All the topics
+ * are remapped to the DDS topic echoed by FastDDSPubsubTest: `mock_to_dds_topic` publishes into
+ * it, and the rest subscribe to it.
+ */
+std::string gen_echo_config_yaml(
+        const std::string& dds_options,
+        const std::vector<std::pair<std::string, std::string> >& topics)
+{
+    const std::string remap = ", remap: {dds: { topic: \"mock_to_dds_topicdds_to_mock_topic\" } }";
+
+    std::string config_yaml;
+    config_yaml += "types:\n";
+    config_yaml += "    idls:\n";
+    config_yaml += "        - >\n";
+    config_yaml += "            struct dds_test_string\n";
+    config_yaml += "            {\n";
+    config_yaml += "                string data;\n";
+    config_yaml += "            };\n";
+    config_yaml += "systems:\n";
+    config_yaml += "    dds: { type: fastdds" + dds_options + " }\n";
+    config_yaml += "    mock: { type: mock }\n";
+    config_yaml += "routes:\n";
+    config_yaml += "    mock_to_dds: { from: mock, to: dds }\n";
+    config_yaml += "    dds_to_mock: { from: dds, to: mock }\n";
+    config_yaml += "topics:\n";
+    for (const auto& topic : topics)
+    {
+        const std::string route = "mock_to_dds_topic" == topic.first ? "mock_to_dds" : "dds_to_mock";
+        config_yaml += "    " + topic.first + ": { type: dds_test_string, route: " + route + remap
+                + topic.second + " }\n";
+    }
+
+    return config_yaml;
+}
+
+/**
+ * Collects the `data` member of the messages received by the mock middleware on a topic.
+ */
+class MockReceiver
+{
+public:
+
+    MockReceiver(
+            const std::string& topic)
+    {
+        subscribed_ = is::sh::mock::subscribe(
+            topic,
+            [this](const eprosima::xtypes::DynamicData& msg)
+            {
+                std::unique_lock<std::mutex> lock(mtx_);
+                messages_.push_back(msg["data"].value<std::string>());
+                cv_.notify_all();
+            });
+    }
+
+    bool subscribed() const
+    {
+        return subscribed_;
+    }
+
+    // Waits until `count` messages have been received, or the timeout expires
+    std::vector<std::string> wait(
+            std::size_t count,
+            std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        cv_.wait_for(lock, timeout, [this, count]()
+                {
+                    return count <= messages_.size();
+                });
+        return messages_;
+    }
+
+private:
+
+    bool subscribed_;
+    std::vector<std::string> messages_;
+    std::mutex mtx_;
+    std::condition_variable cv_;
+};
+
+void publish_string(
+        is::core::InstanceHandle& instance,
+        const std::string& data)
+{
+    const is::TypeRegistry& mock_types = *instance.type_registry("mock");
+    eprosima::xtypes::DynamicData msg_to_sent(*mock_types.at("dds_test_string"));
+    msg_to_sent["data"] = data;
+    is::sh::mock::publish_message("mock_to_dds_topic", msg_to_sent);
+}
+
+TEST(FastDDS, Filtered_subscriptions_only_deliver_matching_samples)
+{
+    // Filtered by a ContentFilteredTopic if Fast DDS can filter the topic type, and by the System
+    // Handle otherwise. The second topic has the same filter as the first but other reader options,
+    // so it gets a DataReader, and a filtered topic, of its own.
+    is::core::InstanceHandle instance = is::run_instance(YAML::Load(gen_echo_config_yaml(
+                "",
+                {
+                    {"mock_to_dds_topic", ""},
+                    {"dds_to_mock_topic", ", filter: \"data = 'pass'\""},
+                    {"dds_to_mock_topic_2", ", filter: \"data = 'pass'\", max_age: 60"},
+                    {"dds_to_mock_topic_3", ", filter: { expression: \"data LIKE %0\", parameters: [\"'pa%'\"] }"}
+                })));
+    ASSERT_TRUE(instance);
+
+    std::mutex disc_mutex;
+    disc_mutex.lock();
+
+    std::unique_ptr<FastDDSPubsubTest> dds_echo = nullptr;
+    ASSERT_NO_THROW(dds_echo.reset(new FastDDSPubsubTest(disc_mutex)));
+
+    disc_mutex.lock();
+
+    std::vector<std::unique_ptr<MockReceiver> > receivers;
+    for (const std::string topic : {"dds_to_mock_topic", "dds_to_mock_topic_2", "dds_to_mock_topic_3"})
+    {
+        receivers.emplace_back(new MockReceiver(topic));
+        ASSERT_TRUE(receivers.back()->subscribed());
+    }
+
+    // Road: [mock -> dds -> dds -> mock (x3)]
+    publish_string(instance, "drop");
+    publish_string(instance, "pass");
+
+    for (const auto& receiver : receivers)
+    {
+        EXPECT_EQ(std::vector<std::string>{"pass"}, receiver->wait(1, 5s));
+    }
+
+    // The discarded sample would have arrived by now
+    std::this_thread::sleep_for(1s);
+    for (const auto& receiver : receivers)
+    {
+        EXPECT_EQ(std::vector<std::string>{"pass"}, receiver->wait(2, 0s));
+    }
+
+    ASSERT_EQ(0, instance.quit().wait_for(1s));
+}
+
+TEST(FastDDS, Stale_samples_are_dropped)
+{
+    // Every sample is older than a microsecond by the time the bridge takes it
+    is::core::InstanceHandle instance = is::run_instance(YAML::Load(gen_echo_config_yaml(
+                "",
+                {
+                    {"mock_to_dds_topic", ""},
+                    {"dds_to_mock_topic", ", max_age: 60"},
+                    {"dds_to_mock_topic_2", ", max_age: 0.000001"}
+                })));
+    ASSERT_TRUE(instance);
+
+    std::mutex disc_mutex;
+    disc_mutex.lock();
+
+    std::unique_ptr<FastDDSPubsubTest> dds_echo = nullptr;
+    ASSERT_NO_THROW(dds_echo.reset(new FastDDSPubsubTest(disc_mutex)));
+
+    disc_mutex.lock();
+
+    MockReceiver fresh("dds_to_mock_topic");
+    MockReceiver stale("dds_to_mock_topic_2");
+    ASSERT_TRUE(fresh.subscribed());
+    ASSERT_TRUE(stale.subscribed());
+
+    // Road: [mock -> dds -> dds -> mock (x2)]
+    publish_string(instance, "stale");
+
+    EXPECT_EQ(std::vector<std::string>{"stale"}, fresh.wait(1, 5s));
+    EXPECT_TRUE(stale.wait(1, 1s).empty());
+
+    ASSERT_EQ(0, instance.quit().wait_for(1s));
+}
+
+TEST(FastDDS, Partitions_route_only_matching_endpoints)
+{
+    // The DDS echo is in partition tenant_a, so the subscriber in tenant_b never matches it
+    is::core::InstanceHandle instance = is::run_instance(YAML::Load(gen_echo_config_yaml(
+                "",
+                {
+                    {"mock_to_dds_topic", ", partitions: tenant_a"},
+                    {"dds_to_mock_topic", ", partitions: [\"tenant_*\"]"},
+                    {"dds_to_mock_topic_2", ", partitions: [tenant_b]"}
+                })));
+    ASSERT_TRUE(instance);
+
+    std::mutex disc_mutex;
+    disc_mutex.lock();
+
+    std::unique_ptr<FastDDSPubsubTest> dds_echo = nullptr;
+    ASSERT_NO_THROW(dds_echo.reset(new FastDDSPubsubTest(disc_mutex, {"tenant_a"})));
+
+    disc_mutex.lock();
+
+    MockReceiver matching("dds_to_mock_topic");
+    MockReceiver other("dds_to_mock_topic_2");
+    ASSERT_TRUE(matching.subscribed());
+    ASSERT_TRUE(other.subscribed());
+
+    // Road: [mock -> dds (tenant_a) -> dds (tenant_a) -> mock (tenant_*)]
+    publish_string(instance, "tenant_a only");
+
+    EXPECT_EQ(std::vector<std::string>{"tenant_a only"}, matching.wait(1, 5s));
+    EXPECT_TRUE(other.wait(1, 1s).empty());
+
+    ASSERT_EQ(0, instance.quit().wait_for(1s));
+}
+
+TEST(FastDDS, Topics_are_sharded_by_participant_index)
+{
+    // The subscriber also matches the publisher of the sibling participant, whose samples are
+    // internal, so only the sample echoed by DDS is delivered
+    is::core::InstanceHandle instance = is::run_instance(YAML::Load(gen_echo_config_yaml(
+                ", participants: 2",
+                {
+                    {"mock_to_dds_topic", ", participant_index: 0"},
+                    {"dds_to_mock_topic", ", participant_index: 1"}
+                })));
+    ASSERT_TRUE(instance);
+
+    std::mutex disc_mutex;
+    disc_mutex.lock();
+
+    std::unique_ptr<FastDDSPubsubTest> dds_echo = nullptr;
+    ASSERT_NO_THROW(dds_echo.reset(new FastDDSPubsubTest(disc_mutex)));
+
+    disc_mutex.lock();
+
+    MockReceiver receiver("dds_to_mock_topic");
+    ASSERT_TRUE(receiver.subscribed());
+
+    // Road: [mock -> dds (participant 0) -> dds -> dds (participant 1) -> mock]
+    publish_string(instance, "sharded");
+
+    EXPECT_EQ(std::vector<std::string>{"sharded"}, receiver.wait(1, 5s));
+    std::this_thread::sleep_for(1s);
+    EXPECT_EQ(std::vector<std::string>{"sharded"}, receiver.wait(2, 0s));
+
+    ASSERT_EQ(0, instance.quit().wait_for(1s));
+}
+
+TEST(FastDDS, Participant_index_out_of_range_is_rejected)
+{
+    is::core::InstanceHandle instance = is::run_instance(YAML::Load(gen_echo_config_yaml(
+                ", participants: 2",
+                {
+                    {"dds_to_mock_topic", ", participant_index: 2"}
+                })));
+    EXPECT_FALSE(instance);
+}
+
+TEST(FastDDS, Lazy_endpoints_are_created_on_discovery)
+{
+    // No DataWriter or DataReader exists until the DDS echo is discovered, so the echo only gets
+    // its four matches once the System Handle has created them
+    is::core::InstanceHandle instance = is::run_instance(YAML::Load(gen_echo_config_yaml(
+                "",
+                {
+                    {"mock_to_dds_topic", ", lazy: true"},
+                    {"dds_to_mock_topic", ", lazy: true"}
+                })));
+    ASSERT_TRUE(instance);
+
+    std::mutex disc_mutex;
+    disc_mutex.lock();
+
+    std::unique_ptr<FastDDSPubsubTest> dds_echo = nullptr;
+    ASSERT_NO_THROW(dds_echo.reset(new FastDDSPubsubTest(disc_mutex)));
+
+    disc_mutex.lock();
+
+    MockReceiver receiver("dds_to_mock_topic");
+    ASSERT_TRUE(receiver.subscribed());
+
+    // Road: [mock -> dds -> dds -> mock]
+    publish_string(instance, "lazy");
+
+    EXPECT_EQ(std::vector<std::string>{"lazy"}, receiver.wait(1, 5s));
+
+    ASSERT_EQ(0, instance.quit().wait_for(1s));
+}
+
+#if FASTRTPS_VERSION_MINOR >= 4
+TEST(FastDDS, Transmit_to_and_receive_from_dds__waitset_reception)
+{
+    is::core::InstanceHandle instance = is::run_instance(YAML::Load(gen_echo_config_yaml(
+                ", reception: { mode: waitset, threads: 2 }",
+                {
+                    {"mock_to_dds_topic", ""},
+                    {"dds_to_mock_topic", ""},
+                    {"dds_to_mock_topic_2", ", max_age: 60"}
+                })));
+    ASSERT_TRUE(instance);
+
+    std::mutex disc_mutex;
+    disc_mutex.lock();
+
+    std::unique_ptr<FastDDSPubsubTest> dds_echo = nullptr;
+    ASSERT_NO_THROW(dds_echo.reset(new FastDDSPubsubTest(disc_mutex)));
+
+    disc_mutex.lock();
+
+    // Each DataReader is handled by its own WaitSet thread
+    MockReceiver first("dds_to_mock_topic");
+    MockReceiver second("dds_to_mock_topic_2");
+    ASSERT_TRUE(first.subscribed());
+    ASSERT_TRUE(second.subscribed());
+
+    // Road: [mock -> dds -> dds -> mock (x2)]
+    publish_string(instance, "waitset");
+
+    EXPECT_EQ(std::vector<std::string>{"waitset"}, first.wait(1, 5s));
+    EXPECT_EQ(std::vector<std::string>{"waitset"}, second.wait(1, 5s));
+
+    ASSERT_EQ(0, instance.quit().wait_for(1s));
+}
+#endif //  if FASTRTPS_VERSION_MINOR >= 4
+
 } //  namespace test
 } //  namespace fastdds
 } //  namespace sh
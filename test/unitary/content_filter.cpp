@@ -0,0 +1,183 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <ContentFilter.hpp>
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace fastdds {
+namespace test {
+
+namespace {
+
+using Sample = std::map<std::string, ContentFilter::Value>;
+
+bool matches(
+        const ContentFilter& filter,
+        const Sample& sample)
+{
+    return filter.evaluate([&sample](const ContentFilter::Path& path, ContentFilter::Value& value)
+                   {
+                       std::string name;
+                       for (const std::string& member : path)
+                       {
+                           name += (name.empty() ? "" : ".") + member;
+                       }
+
+                       auto it = sample.find(name);
+                       if (sample.end() == it)
+                       {
+                           return false;
+                       }
+                       value = it->second;
+                       return true;
+                   });
+}
+
+} //  anonymous namespace
+
+TEST(FastDDSUnitary, Content_filter__comparisons)
+{
+    Sample sample = {
+        {"robot_id", int64_t(7)},
+        {"battery", 0.42},
+        {"name", std::string("explorer")},
+        {"active", true},
+        {"pose.position.x", -1.5}};
+
+    EXPECT_TRUE(matches(ContentFilter("robot_id = 7"), sample));
+    EXPECT_FALSE(matches(ContentFilter("robot_id <> 7"), sample));
+    EXPECT_TRUE(matches(ContentFilter("robot_id != 3"), sample));
+    EXPECT_TRUE(matches(ContentFilter("battery < 0.5"), sample));
+    EXPECT_TRUE(matches(ContentFilter("battery >= 0.42"), sample));
+    EXPECT_TRUE(matches(ContentFilter("robot_id > 6.5"), sample));
+    EXPECT_TRUE(matches(ContentFilter("name = 'explorer'"), sample));
+    EXPECT_TRUE(matches(ContentFilter("active = TRUE"), sample));
+    EXPECT_TRUE(matches(ContentFilter("pose.position.x < -1"), sample));
+    EXPECT_TRUE(matches(ContentFilter("7 = robot_id"), sample));
+
+    // Values of different kinds and unknown fields never match
+    EXPECT_FALSE(matches(ContentFilter("name = 7"), sample));
+    EXPECT_FALSE(matches(ContentFilter("unknown = 7"), sample));
+    EXPECT_FALSE(matches(ContentFilter("unknown <> 7"), sample));
+}
+
+TEST(FastDDSUnitary, Content_filter__logical_operators)
+{
+    Sample sample = {
+        {"robot_id", int64_t(7)},
+        {"battery", 0.42},
+        {"name", std::string("explorer")}};
+
+    EXPECT_TRUE(matches(ContentFilter("robot_id = 7 AND battery < 0.5"), sample));
+    EXPECT_FALSE(matches(ContentFilter("robot_id = 7 AND battery > 0.5"), sample));
+    EXPECT_TRUE(matches(ContentFilter("robot_id = 3 or battery < 0.5"), sample));
+    EXPECT_TRUE(matches(ContentFilter("NOT robot_id = 3"), sample));
+    EXPECT_FALSE(matches(ContentFilter("robot_id = 3 OR robot_id = 4 AND name = 'explorer'"), sample));
+    EXPECT_TRUE(matches(ContentFilter("(robot_id = 3 OR robot_id = 7) AND name = 'explorer'"), sample));
+    EXPECT_TRUE(matches(ContentFilter("robot_id BETWEEN 5 AND 10 AND battery BETWEEN 0 AND 1"), sample));
+    EXPECT_FALSE(matches(ContentFilter("robot_id BETWEEN 8 AND 10"), sample));
+}
+
+TEST(FastDDSUnitary, Content_filter__like)
+{
+    Sample sample = {{"name", std::string("robot_12")}};
+
+    EXPECT_TRUE(matches(ContentFilter("name LIKE 'robot%'"), sample));
+    EXPECT_TRUE(matches(ContentFilter("name LIKE '%_12'"), sample));
+    EXPECT_TRUE(matches(ContentFilter("name LIKE 'robot__2'"), sample));
+    EXPECT_FALSE(matches(ContentFilter("name LIKE 'drone%'"), sample));
+    EXPECT_FALSE(matches(ContentFilter("name LIKE 'robot_1'"), sample));
+}
+
+TEST(FastDDSUnitary, Content_filter__parameters)
+{
+    Sample sample = {
+        {"robot_id", int64_t(7)},
+        {"name", std::string("it's")}};
+
+    ContentFilter filter("robot_id = %0 AND name = %1", {"7", "'it''s'"});
+    EXPECT_TRUE(matches(filter, sample));
+
+    EXPECT_FALSE(matches(ContentFilter("robot_id > %0", {"-3.5e1"}), {{"robot_id", int64_t(-40)}}));
+    EXPECT_TRUE(matches(ContentFilter("robot_id < %0", {"-3.5e1"}), {{"robot_id", int64_t(-40)}}));
+}
+
+TEST(FastDDSUnitary, Content_filter__fields)
+{
+    ContentFilter filter("a = 1 AND b.c > 2 OR a < 0");
+
+    ASSERT_EQ(2u, filter.fields().size());
+    EXPECT_EQ(ContentFilter::Path({"a"}), filter.fields()[0]);
+    EXPECT_EQ(ContentFilter::Path({"b", "c"}), filter.fields()[1]);
+}
+
+TEST(FastDDSUnitary, Content_filter__enumerations)
+{
+    const ContentFilter::Enumerators colors = {{"RED", 0}, {"GREEN", 1}, {"BLUE", 2}};
+    Sample sample = {{"color", int64_t(1)}};
+
+    ContentFilter equal("color = 'GREEN'");
+    equal.set_enumerators({"color"}, colors);
+    EXPECT_TRUE(matches(equal, sample));
+
+    ContentFilter parameter("color <> %0", {"'RED'"});
+    parameter.set_enumerators({"color"}, colors);
+    EXPECT_TRUE(matches(parameter, sample));
+
+    ContentFilter between("color BETWEEN 'GREEN' AND 'BLUE'");
+    between.set_enumerators({"color"}, colors);
+    EXPECT_TRUE(matches(between, sample));
+
+    // Integer values are still accepted
+    ContentFilter integer("color = 1");
+    integer.set_enumerators({"color"}, colors);
+    EXPECT_TRUE(matches(integer, sample));
+
+    // Without enumerators, names are compared as strings
+    EXPECT_FALSE(matches(ContentFilter("color = 'GREEN'"), sample));
+
+    EXPECT_THROW(ContentFilter("color = 'PURPLE'").set_enumerators({"color"}, colors), DDSMiddlewareException);
+    EXPECT_THROW(ContentFilter("color LIKE 'G%'").set_enumerators({"color"}, colors), DDSMiddlewareException);
+}
+
+TEST(FastDDSUnitary, Content_filter__invalid_expressions)
+{
+    EXPECT_THROW(ContentFilter(""), DDSMiddlewareException);
+    EXPECT_THROW(ContentFilter("robot_id"), DDSMiddlewareException);
+    EXPECT_THROW(ContentFilter("robot_id = "), DDSMiddlewareException);
+    EXPECT_THROW(ContentFilter("robot_id = 'open"), DDSMiddlewareException);
+    EXPECT_THROW(ContentFilter("(robot_id = 7"), DDSMiddlewareException);
+    EXPECT_THROW(ContentFilter("robot_id = 7 robot_id"), DDSMiddlewareException);
+    EXPECT_THROW(ContentFilter("robot_id = %0"), DDSMiddlewareException);
+    EXPECT_THROW(ContentFilter("robot_id = %0", {"7 8"}), DDSMiddlewareException);
+    EXPECT_THROW(ContentFilter("robot_id BETWEEN 1 OR 2"), DDSMiddlewareException);
+    EXPECT_THROW(ContentFilter("a..b = 1"), DDSMiddlewareException);
+    EXPECT_THROW(ContentFilter("robot_id # 7"), DDSMiddlewareException);
+}
+
+} //  namespace test
+} //  namespace fastdds
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
@@ -562,7 +562,8 @@ TEST(FastDDSUnitary, Convert_between_Integration_Service_and_DDS__basic_type)
     const xtypes::DynamicType* basic_struct = result["BasicStruct"].get();
     ASSERT_NE(basic_struct, nullptr);
     // Convert type from Integration Service to dds
-    fastrtps::types::DynamicTypeBuilder* builder = Conversion::create_builder(*basic_struct);
+    ConversionContext conversion;
+    fastrtps::types::DynamicTypeBuilder* builder = conversion.create_builder(*basic_struct);
     ASSERT_NE(builder, nullptr);
     fastrtps::types::DynamicType_ptr dds_struct = builder->build();
     fastrtps::types::DynamicData_ptr dds_data_ptr(
@@ -593,7 +594,8 @@ TEST(FastDDSUnitary, Convert_between_Integration_Service_and_DDS__nested_sequenc
     const xtypes::DynamicType* nested_sequence = result["NestedSequence"].get();
     ASSERT_NE(nested_sequence, nullptr);
     // Convert type from Integration Service to dds
-    fastrtps::types::DynamicTypeBuilder* builder = Conversion::create_builder(*nested_sequence);
+    ConversionContext conversion;
+    fastrtps::types::DynamicTypeBuilder* builder = conversion.create_builder(*nested_sequence);
     ASSERT_NE(builder, nullptr);
     fastrtps::types::DynamicType_ptr dds_sequence = builder->build();
     fastrtps::types::DynamicData_ptr dds_data_ptr(
@@ -627,7 +629,8 @@ TEST(FastDDSUnitary, Convert_between_Integration_Service_and_DDS__nested_array)
     const xtypes::DynamicType* nested_array = result["NestedArray"].get();
     ASSERT_NE(nested_array, nullptr);
     // Convert type from Integration Service to dds
-    fastrtps::types::DynamicTypeBuilder* builder = Conversion::create_builder(*nested_array);
+    ConversionContext conversion;
+    fastrtps::types::DynamicTypeBuilder* builder = conversion.create_builder(*nested_array);
     ASSERT_NE(builder, nullptr);
     fastrtps::types::DynamicType_ptr dds_array = builder->build();
     fastrtps::types::DynamicData_ptr dds_data_ptr(
@@ -661,7 +664,8 @@ TEST(FastDDSUnitary, Convert_between_Integration_Service_and_DDS__mixed_struct)
     const xtypes::DynamicType* mixed_struct = result["MixedStruct"].get();
     ASSERT_NE(mixed_struct, nullptr);
     // Convert type from Integration Service to dds
-    fastrtps::types::DynamicTypeBuilder* builder = Conversion::create_builder(*mixed_struct);
+    ConversionContext conversion;
+    fastrtps::types::DynamicTypeBuilder* builder = conversion.create_builder(*mixed_struct);
     ASSERT_NE(builder, nullptr);
     fastrtps::types::DynamicType_ptr dds_struct = builder->build();
     fastrtps::types::DynamicData_ptr dds_data_ptr(
@@ -692,7 +696,8 @@ TEST(FastDDSUnitary, Convert_between_Integration_Service_and_DDS__union_struct)
     const xtypes::DynamicType* union_struct = result["MyUnionStruct"].get();
     ASSERT_NE(union_struct, nullptr);
     // Convert type from Integration Service to dds
-    fastrtps::types::DynamicTypeBuilder* builder = Conversion::create_builder(*union_struct);
+    ConversionContext conversion;
+    fastrtps::types::DynamicTypeBuilder* builder = conversion.create_builder(*union_struct);
     ASSERT_NE(builder, nullptr);
     fastrtps::types::DynamicType_ptr dds_struct = builder->build();
     fastrtps::types::DynamicData_ptr dds_data_ptr(
@@ -750,7 +755,8 @@ TEST(FastDDSUnitary, Convert_between_Integration_Service_and_DDS__namespaced_typ
             result["fastdds_sh::unit_test::types::NamespacedType"].get();
     ASSERT_NE(namespaced_type, nullptr);
     // Convert type from Integration Service to dds
-    fastrtps::types::DynamicTypeBuilder* builder = Conversion::create_builder(*namespaced_type);
+    ConversionContext conversion;
+    fastrtps::types::DynamicTypeBuilder* builder = conversion.create_builder(*namespaced_type);
     ASSERT_NE(builder, nullptr);
     fastrtps::types::DynamicType_ptr dds_namespaced_type = builder->build();
     fastrtps::types::DynamicData_ptr dds_data_ptr(
@@ -773,6 +779,258 @@ TEST(FastDDSUnitary, Convert_between_Integration_Service_and_DDS__namespaced_typ
     check_basic_struct(wayback["basic"]);
 }
 
+TEST(FastDDSUnitary, Conversion__is_bounded)
+{
+    xtypes::StructType bounded("BoundedType");
+    bounded.add_member("id", xtypes::primitive_type<int32_t>());
+    bounded.add_member("name", xtypes::StringType(32));
+    bounded.add_member("values", xtypes::SequenceType(xtypes::primitive_type<float>(), 16));
+    bounded.add_member("matrix", xtypes::ArrayType(xtypes::primitive_type<double>(), 9));
+    ASSERT_TRUE(Conversion::is_bounded(bounded));
+
+    xtypes::StructType unbounded_string("UnboundedString");
+    unbounded_string.add_member("name", xtypes::StringType());
+    ASSERT_FALSE(Conversion::is_bounded(unbounded_string));
+
+    xtypes::StructType nested("NestedUnbounded");
+    nested.add_member("inner", bounded);
+    nested.add_member("values", xtypes::SequenceType(xtypes::primitive_type<float>()));
+    ASSERT_FALSE(Conversion::is_bounded(nested));
+
+    xtypes::StructType bounded_sequence_of_unbounded("BoundedSequenceOfUnbounded");
+    bounded_sequence_of_unbounded.add_member("names", xtypes::SequenceType(xtypes::StringType(), 4));
+    ASSERT_FALSE(Conversion::is_bounded(bounded_sequence_of_unbounded));
+}
+
+TEST(FastDDSUnitary, Conversion__context)
+{
+    xtypes::StructType point("Point");
+    point.add_member("x", xtypes::primitive_type<double>());
+    point.add_member("y", xtypes::primitive_type<double>());
+
+    // Builders are kept per context, so each system owns its own
+    ConversionContext conversion;
+    fastrtps::types::DynamicTypeBuilder* builder = conversion.create_builder(point);
+    ASSERT_NE(builder, nullptr);
+    EXPECT_EQ(builder, conversion.create_builder(point));
+
+    ConversionContext other_conversion;
+    fastrtps::types::DynamicTypeBuilder* other_builder = other_conversion.create_builder(point);
+    ASSERT_NE(other_builder, nullptr);
+    EXPECT_NE(builder, other_builder);
+    EXPECT_EQ(builder->get_name(), other_builder->get_name());
+}
+
+TEST(FastDDSUnitary, Conversion__fingerprint)
+{
+    xtypes::StructType point("Point");
+    point.add_member("x", xtypes::primitive_type<double>());
+    point.add_member("y", xtypes::primitive_type<double>());
+
+    xtypes::StructType vector("Vector");
+    vector.add_member("x", xtypes::primitive_type<double>());
+    vector.add_member("y", xtypes::primitive_type<double>());
+
+    xtypes::StructType renamed("Renamed");
+    renamed.add_member("x", xtypes::primitive_type<double>());
+    renamed.add_member("z", xtypes::primitive_type<double>());
+
+    xtypes::StructType retyped("Retyped");
+    retyped.add_member("x", xtypes::primitive_type<double>());
+    retyped.add_member("y", xtypes::primitive_type<float>());
+
+    // Type names do not take part, but member names and types do
+    EXPECT_EQ(Conversion::fingerprint(point), Conversion::fingerprint(vector));
+    EXPECT_NE(Conversion::fingerprint(point), Conversion::fingerprint(renamed));
+    EXPECT_NE(Conversion::fingerprint(point), Conversion::fingerprint(retyped));
+    EXPECT_EQ(Conversion::fingerprint(point), Conversion::fingerprint(xtypes::AliasType(point, "PointAlias")));
+
+    EXPECT_NE(Conversion::fingerprint(xtypes::StringType(10)), Conversion::fingerprint(xtypes::StringType(20)));
+    EXPECT_NE(Conversion::fingerprint(xtypes::SequenceType(point)),
+            Conversion::fingerprint(xtypes::SequenceType(point, 5)));
+
+    // Memoized by the context, with the same result
+    ConversionContext memo;
+    EXPECT_EQ(Conversion::fingerprint(point), Conversion::fingerprint(point, &memo));
+    EXPECT_EQ(Conversion::fingerprint(point), Conversion::fingerprint(point, &memo));
+    EXPECT_EQ(Conversion::fingerprint(point, &memo), Conversion::fingerprint(vector, &memo));
+
+    xtypes::StructType path("Path");
+    path.add_member("start", point);
+    path.add_member("end", vector);
+
+    // Nested types with the same structure share their builder
+    ConversionContext conversion;
+    fastrtps::types::DynamicTypeBuilder* builder = conversion.create_builder(path);
+    ASSERT_NE(builder, nullptr);
+    fastrtps::types::DynamicType_ptr dds_struct = builder->build();
+    fastrtps::types::DynamicData_ptr dds_data_ptr(
+        fastrtps::types::DynamicDataFactory::get_instance()->create_data(dds_struct));
+    fastrtps::types::DynamicData* dds_data =
+            static_cast<fastrtps::types::DynamicData*>(dds_data_ptr.get());
+
+    xtypes::DynamicData xtypes_data(path);
+    xtypes_data["start"]["x"] = 1.5;
+    xtypes_data["end"]["y"] = -2.5;
+    ASSERT_TRUE(Conversion::xtypes_to_fastdds(xtypes_data, dds_data));
+
+    xtypes::DynamicData converted(path);
+    ASSERT_TRUE(Conversion::fastdds_to_xtypes(dds_data, converted));
+    EXPECT_EQ(1.5, converted["start"]["x"].value<double>());
+    EXPECT_EQ(-2.5, converted["end"]["y"].value<double>());
+}
+
+TEST(FastDDSUnitary, Conversion__identical_types)
+{
+    xtypes::StructType ros_string("std_msgs/String");
+    ros_string.add_member("data", xtypes::StringType());
+
+    xtypes::StructType dds_string("std_msgs::msg::String");
+    dds_string.add_member("data", xtypes::StringType());
+
+    // Each name gets its own builder, built from the same structure
+    ConversionContext conversion;
+    fastrtps::types::DynamicTypeBuilder* ros_builder = conversion.create_builder(ros_string);
+    fastrtps::types::DynamicTypeBuilder* dds_builder = conversion.create_builder(dds_string);
+    ASSERT_NE(ros_builder, nullptr);
+    ASSERT_NE(dds_builder, nullptr);
+    EXPECT_NE(ros_builder, dds_builder);
+    EXPECT_EQ("std_msgs__String", ros_builder->get_name());
+    EXPECT_EQ("String", dds_builder->get_name());
+
+    // Data of either type is converted through any of the builders
+    fastrtps::types::DynamicType_ptr dds_struct = dds_builder->build();
+    fastrtps::types::DynamicData_ptr dds_data_ptr(
+        fastrtps::types::DynamicDataFactory::get_instance()->create_data(dds_struct));
+    fastrtps::types::DynamicData* dds_data =
+            static_cast<fastrtps::types::DynamicData*>(dds_data_ptr.get());
+
+    xtypes::DynamicData xtypes_data(ros_string);
+    xtypes_data["data"] = "hello";
+    ASSERT_TRUE(Conversion::xtypes_to_fastdds(xtypes_data, dds_data));
+
+    xtypes::DynamicData converted(dds_string);
+    ASSERT_TRUE(Conversion::fastdds_to_xtypes(dds_data, converted));
+    EXPECT_EQ("hello", converted["data"].value<std::string>());
+}
+
+TEST(FastDDSUnitary, Conversion__projection)
+{
+    xtypes::StructType position("Position");
+    position.add_member("x", xtypes::primitive_type<double>());
+    position.add_member("y", xtypes::primitive_type<double>());
+
+    xtypes::StructType pose("Pose");
+    pose.add_member("position", position);
+    pose.add_member("frame", xtypes::StringType());
+
+    xtypes::StructType state("RobotState");
+    state.add_member("robot_id", xtypes::primitive_type<int32_t>());
+    state.add_member("name", xtypes::StringType());
+    state.add_member("pose", pose);
+    state.add_member("readings", xtypes::SequenceType(xtypes::primitive_type<float>()));
+
+    EXPECT_THROW(Conversion::create_projection(state, {"unknown"}), DDSMiddlewareException);
+    EXPECT_THROW(Conversion::create_projection(state, {"robot_id.x"}), DDSMiddlewareException);
+    EXPECT_THROW(Conversion::create_projection(state, {""}), DDSMiddlewareException);
+
+    std::shared_ptr<Projection> projection = Conversion::create_projection(
+        state, {"robot_id", "pose.position.x", "pose.frame"});
+
+    ConversionContext conversion;
+    fastrtps::types::DynamicTypeBuilder* builder = conversion.create_builder(state);
+    ASSERT_NE(builder, nullptr);
+    fastrtps::types::DynamicType_ptr dds_struct = builder->build();
+    fastrtps::types::DynamicData_ptr dds_data_ptr(
+        fastrtps::types::DynamicDataFactory::get_instance()->create_data(dds_struct));
+    fastrtps::types::DynamicData* dds_data =
+            static_cast<fastrtps::types::DynamicData*>(dds_data_ptr.get());
+
+    xtypes::DynamicData xtypes_data(state);
+    xtypes_data["robot_id"] = 7;
+    xtypes_data["name"] = "explorer";
+    xtypes_data["pose"]["position"]["x"] = 1.5;
+    xtypes_data["pose"]["position"]["y"] = 2.5;
+    xtypes_data["pose"]["frame"] = "map";
+    xtypes_data["readings"].push(0.5f);
+
+    // Publishing direction: only the selected members are written
+    ASSERT_TRUE(Conversion::xtypes_to_fastdds(xtypes_data, dds_data, projection.get()));
+    xtypes::DynamicData written(state);
+    ASSERT_TRUE(Conversion::fastdds_to_xtypes(dds_data, written));
+    EXPECT_EQ(7, written["robot_id"].value<int32_t>());
+    EXPECT_EQ("", written["name"].value<std::string>());
+    EXPECT_EQ(1.5, written["pose"]["position"]["x"].value<double>());
+    EXPECT_EQ(0.0, written["pose"]["position"]["y"].value<double>());
+    EXPECT_EQ("map", written["pose"]["frame"].value<std::string>());
+    EXPECT_EQ(0u, written["readings"].size());
+
+    // Reception direction: only the selected members are converted
+    ASSERT_TRUE(Conversion::xtypes_to_fastdds(xtypes_data, dds_data));
+    xtypes::DynamicData received(state);
+    ASSERT_TRUE(Conversion::fastdds_to_xtypes(dds_data, received, projection.get()));
+    EXPECT_EQ(7, received["robot_id"].value<int32_t>());
+    EXPECT_EQ("", received["name"].value<std::string>());
+    EXPECT_EQ(1.5, received["pose"]["position"]["x"].value<double>());
+    EXPECT_EQ(0.0, received["pose"]["position"]["y"].value<double>());
+    EXPECT_EQ("map", received["pose"]["frame"].value<std::string>());
+    EXPECT_EQ(0u, received["readings"].size());
+
+    // Selecting a structure selects all of its members
+    projection = Conversion::create_projection(state, {"pose.position.x", "pose"});
+    xtypes::DynamicData whole_pose(state);
+    ASSERT_TRUE(Conversion::fastdds_to_xtypes(dds_data, whole_pose, projection.get()));
+    EXPECT_EQ(0, whole_pose["robot_id"].value<int32_t>());
+    EXPECT_EQ(2.5, whole_pose["pose"]["position"]["y"].value<double>());
+}
+
+TEST(FastDDSUnitary, Conversion__filter_members)
+{
+    xtypes::idl::Context context = xtypes::idl::parse_file(fastdds_sh_unit_test_types);
+    ASSERT_TRUE(context.success);
+
+    auto result = context.get_all_scoped_types();
+    const xtypes::DynamicType* basic_struct = result["BasicStruct"].get();
+    ASSERT_NE(basic_struct, nullptr);
+
+    ContentFilter::Enumerators enumerators;
+    EXPECT_FALSE(Conversion::get_enumerators(*basic_struct, {"my_int32"}, enumerators));
+    ASSERT_TRUE(Conversion::get_enumerators(*basic_struct, {"my_enum"}, enumerators));
+    EXPECT_EQ((ContentFilter::Enumerators{{"A", 0}, {"B", 1}, {"C", 2}}), enumerators);
+
+    ConversionContext conversion;
+    fastrtps::types::DynamicTypeBuilder* builder = conversion.create_builder(*basic_struct);
+    ASSERT_NE(builder, nullptr);
+    fastrtps::types::DynamicType_ptr dds_struct = builder->build();
+    fastrtps::types::DynamicData_ptr dds_data_ptr(
+        fastrtps::types::DynamicDataFactory::get_instance()->create_data(dds_struct));
+    fastrtps::types::DynamicData* dds_data =
+            static_cast<fastrtps::types::DynamicData*>(dds_data_ptr.get());
+
+    xtypes::DynamicData xtypes_data(*basic_struct);
+    fill_basic_struct(xtypes_data);
+    ASSERT_TRUE(Conversion::xtypes_to_fastdds(xtypes_data, dds_data));
+
+    // Wide strings are read as UTF-8, like the filter expressions
+    ContentFilter::Value value;
+    ASSERT_TRUE(Conversion::fastdds_member_value(dds_data, {"my_wstring"}, value));
+    EXPECT_EQ(ContentFilter::Value(std::string("Testing a wstring: \xE2\x82\xB1")), value);
+
+    // Enumerators are compared by name
+    auto reader = [dds_data](const ContentFilter::Path& path, ContentFilter::Value& field_value)
+            {
+                return Conversion::fastdds_member_value(dds_data, path, field_value);
+            };
+
+    ContentFilter matching("my_enum = 'C' AND my_wstring LIKE '%\xE2\x82\xB1'");
+    matching.set_enumerators({"my_enum"}, enumerators);
+    EXPECT_TRUE(matching.evaluate(reader));
+
+    ContentFilter not_matching("my_enum = 'A'");
+    not_matching.set_enumerators({"my_enum"}, enumerators);
+    EXPECT_FALSE(not_matching.evaluate(reader));
+}
+
 } //  namespace test
 } //  namespace fastdds
 } //  namespace sh
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <OrderedExecutor.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace fastdds {
+namespace test {
+
+TEST(FastDDSUnitary, Ordered_executor__keeps_order_per_key)
+{
+    constexpr std::size_t keys = 8;
+    constexpr std::size_t tasks_per_key = 500;
+
+    std::mutex mtx;
+    std::map<OrderedExecutor::Key, std::vector<std::size_t> > executed;
+
+    {
+        OrderedExecutor executor(4);
+        for (std::size_t i = 0; i < tasks_per_key; ++i)
+        {
+            for (OrderedExecutor::Key key = 0; key < keys; ++key)
+            {
+                executor.submit(key, [&, key, i]()
+                        {
+                            std::unique_lock<std::mutex> lock(mtx);
+                            executed[key].push_back(i);
+                        });
+            }
+        }
+        // Destruction runs every pending task
+    }
+
+    ASSERT_EQ(keys, executed.size());
+    for (const auto& pair : executed)
+    {
+        ASSERT_EQ(tasks_per_key, pair.second.size());
+        for (std::size_t i = 0; i < tasks_per_key; ++i)
+        {
+            ASSERT_EQ(i, pair.second[i]);
+        }
+    }
+}
+
+TEST(FastDDSUnitary, Ordered_executor__serializes_same_key_and_parallelizes_different_keys)
+{
+    using namespace std::chrono_literals;
+
+    std::atomic<int> running_same_key(0);
+    std::atomic<int> max_running_same_key(0);
+    std::atomic<int> running(0);
+    std::atomic<int> max_running(0);
+
+    auto track = [](std::atomic<int>& current, std::atomic<int>& max)
+            {
+                int now = ++current;
+                int prev = max.load();
+                while (now > prev && !max.compare_exchange_weak(prev, now))
+                {
+                }
+            };
+
+    {
+        OrderedExecutor executor(4);
+        for (int i = 0; i < 20; ++i)
+        {
+            executor.submit(0, [&]()
+                    {
+                        track(running_same_key, max_running_same_key);
+                        std::this_thread::sleep_for(1ms);
+                        --running_same_key;
+                    });
+
+            executor.submit(static_cast<OrderedExecutor::Key>(i + 1), [&]()
+                    {
+                        track(running, max_running);
+                        std::this_thread::sleep_for(5ms);
+                        --running;
+                    });
+        }
+    }
+
+    ASSERT_EQ(1, max_running_same_key.load());
+    ASSERT_LT(1, max_running.load());
+}
+
+TEST(FastDDSUnitary, Ordered_executor__dispatch_configuration)
+{
+    // Without mode, each sample gets its own thread
+    EXPECT_EQ(nullptr, OrderedExecutor::create(YAML::Load("{}")));
+    EXPECT_EQ(nullptr, OrderedExecutor::create(YAML::Load("{threads: 2}")));
+    EXPECT_EQ(nullptr, OrderedExecutor::create(YAML::Load("{mode: thread_per_sample}")));
+
+    std::unique_ptr<OrderedExecutor> executor = OrderedExecutor::create(YAML::Load("{mode: ordered, threads: 2}"));
+    ASSERT_NE(nullptr, executor);
+    EXPECT_EQ(2u, executor->size());
+
+    EXPECT_THROW(OrderedExecutor::create(YAML::Load("{mode: unknown}")), DDSMiddlewareException);
+}
+
+} //  namespace test
+} //  namespace fastdds
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima